@@ -0,0 +1,242 @@
+/*
+ * 分块矩阵乘法（GEMM）
+ * multidim_array.c 中 matrix_multiply 是 i-j-k 三重循环：内层沿 b 的列方向
+ * 跨行访问，矩阵稍大就不断缺失缓存。这里按 BLIS 的方式重写：
+ *   - 把 B 的 KC x NC 块、A 的 MC x KC 块打包成连续的窄条（panel），
+ *     KC、MC、NC 分别让 B 的窄条留在 L1、A 的块留在 L2、B 的块留在 L3
+ *   - 最内层是 MR x NR 的微内核，x86 上用 AVX2/FMA，其他情况用可移植的 C
+ *   - 较大的矩阵按行（或列）分给多个线程，每个线程独立打包和计算
+ * 支持 int32_t、float、double 三种元素，矩阵均为行优先连续存储：
+ *   gemm_i32  gemm_f32  gemm_f64                       C = A x B
+ *   matrix_transpose_i32  matrix_transpose_f32  matrix_transpose_f64
+ * 所有函数只包含在本头文件中，直接 #include 即可使用（需要链接 pthread）。
+ * C17/C18 标准
+ *
+ * 与原函数的差别：
+ *   - int32_t 的乘加按 2^32 取模回绕（原函数溢出时是未定义行为）
+ *   - 浮点的求和顺序不同，结果与三重循环只在舍入误差范围内一致
+ */
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+enum { GEMM_PORTABLE = 0, GEMM_AVX2 = 1 };
+
+#define GEMM_MR 6                   // 微内核的行数
+#define GEMM_ALIGN 64               // 打包缓冲区的对齐
+#define GEMM_MAX_THREADS 64
+#define GEMM_MIN_WORK (1u << 22)    // 每个线程至少分到的乘加次数
+#define GEMM_TRANSPOSE_LEAF 16      // 转置递归到这个大小为止
+
+// ---------------------------------------------------------------------------
+// 运行时选择
+
+// CPU 支持的最高级别：AVX2 微内核同时需要 FMA
+static inline int gemm_supported(void) {
+#ifdef GEMM_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? GEMM_AVX2 : GEMM_PORTABLE;
+#else
+    return GEMM_PORTABLE;
+#endif
+}
+
+static inline atomic_int *gemm_level_slot(void) {
+    static atomic_int level = -1;
+    return &level;
+}
+
+// 当前使用的级别；第一次调用时检测 CPU
+static inline int gemm_level(void) {
+    int level = atomic_load_explicit(gemm_level_slot(), memory_order_relaxed);
+    if (level < 0) {
+        level = gemm_supported();
+        atomic_store_explicit(gemm_level_slot(), level, memory_order_relaxed);
+    }
+    return level;
+}
+
+// 指定级别（超过 CPU 支持的级别时取支持的最高级别），返回实际使用的级别
+static inline int gemm_set_level(int level) {
+    int best = gemm_supported();
+    if (level > best) level = best;
+    if (level < GEMM_PORTABLE) level = GEMM_PORTABLE;
+    atomic_store_explicit(gemm_level_slot(), level, memory_order_relaxed);
+    return level;
+}
+
+static inline const char *gemm_level_name(int level) {
+    static const char *const names[] = {"portable", "AVX2"};
+    return names[level];
+}
+
+static inline atomic_int *gemm_threads_slot(void) {
+    static atomic_int threads = 0;
+    return &threads;
+}
+
+// 最多使用的线程数；默认为在线的 CPU 数
+static inline int gemm_threads(void) {
+    int threads = atomic_load_explicit(gemm_threads_slot(), memory_order_relaxed);
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus < 1 ? 1 : cpus > GEMM_MAX_THREADS ? GEMM_MAX_THREADS : (int)cpus;
+    }
+    return threads;
+}
+
+// 指定线程数，0 表示恢复默认；返回实际使用的上限
+static inline int gemm_set_threads(int threads) {
+    if (threads < 0) threads = 0;
+    if (threads > GEMM_MAX_THREADS) threads = GEMM_MAX_THREADS;
+    atomic_store_explicit(gemm_threads_slot(), threads, memory_order_relaxed);
+    return gemm_threads();
+}
+
+static inline size_t gemm_min(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+static inline size_t gemm_round_up(size_t x, size_t to) {
+    return (x + to - 1) / to * to;
+}
+
+// ---------------------------------------------------------------------------
+// 三种元素类型，各展开一次 gemm_kernels.h
+
+// int32_t：没有整数 FMA，用 mullo + add；标量运算转成 uint32_t 以按模回绕
+#define T int32_t
+#define KSUF i32
+#define NR 16
+#define KC 384
+#define MC 96
+#define NC 4096
+#define K_MADD(acc, a, b) ((int32_t)((uint32_t)(acc) + (uint32_t)(a) * (uint32_t)(b)))
+#define K_ADD(x, y) ((int32_t)((uint32_t)(x) + (uint32_t)(y)))
+#ifdef GEMM_X86
+#define VEC __m256i
+#define V_ZERO() _mm256_setzero_si256()
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define V_LOADA(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define V_BCAST(p) _mm256_set1_epi32(*(p))
+#define V_MADD(c, a, b) _mm256_add_epi32((c), _mm256_mullo_epi32((a), (b)))
+#define V_ADD(a, b) _mm256_add_epi32((a), (b))
+#endif
+
+#include "gemm_kernels.h"
+
+#undef T
+#undef KSUF
+#undef NR
+#undef KC
+#undef MC
+#undef NC
+#undef K_MADD
+#undef K_ADD
+#ifdef GEMM_X86
+#undef VEC
+#undef V_ZERO
+#undef V_LOADU
+#undef V_LOADA
+#undef V_STOREU
+#undef V_BCAST
+#undef V_MADD
+#undef V_ADD
+#endif
+
+#define T float
+#define KSUF f32
+#define NR 16
+#define KC 384
+#define MC 96
+#define NC 4096
+#define K_MADD(acc, a, b) ((acc) + (a) * (b))
+#define K_ADD(x, y) ((x) + (y))
+#ifdef GEMM_X86
+#define VEC __m256
+#define V_ZERO() _mm256_setzero_ps()
+#define V_LOADU(p) _mm256_loadu_ps(p)
+#define V_LOADA(p) _mm256_load_ps(p)
+#define V_STOREU(p, v) _mm256_storeu_ps((p), (v))
+#define V_BCAST(p) _mm256_broadcast_ss(p)
+#define V_MADD(c, a, b) _mm256_fmadd_ps((a), (b), (c))
+#define V_ADD(a, b) _mm256_add_ps((a), (b))
+#endif
+
+#include "gemm_kernels.h"
+
+#undef T
+#undef KSUF
+#undef NR
+#undef KC
+#undef MC
+#undef NC
+#undef K_MADD
+#undef K_ADD
+#ifdef GEMM_X86
+#undef VEC
+#undef V_ZERO
+#undef V_LOADU
+#undef V_LOADA
+#undef V_STOREU
+#undef V_BCAST
+#undef V_MADD
+#undef V_ADD
+#endif
+
+#define T double
+#define KSUF f64
+#define NR 8
+#define KC 384
+#define MC 48
+#define NC 4096
+#define K_MADD(acc, a, b) ((acc) + (a) * (b))
+#define K_ADD(x, y) ((x) + (y))
+#ifdef GEMM_X86
+#define VEC __m256d
+#define V_ZERO() _mm256_setzero_pd()
+#define V_LOADU(p) _mm256_loadu_pd(p)
+#define V_LOADA(p) _mm256_load_pd(p)
+#define V_STOREU(p, v) _mm256_storeu_pd((p), (v))
+#define V_BCAST(p) _mm256_broadcast_sd(p)
+#define V_MADD(c, a, b) _mm256_fmadd_pd((a), (b), (c))
+#define V_ADD(a, b) _mm256_add_pd((a), (b))
+#endif
+
+#include "gemm_kernels.h"
+
+#undef T
+#undef KSUF
+#undef NR
+#undef KC
+#undef MC
+#undef NC
+#undef K_MADD
+#undef K_ADD
+#ifdef GEMM_X86
+#undef VEC
+#undef V_ZERO
+#undef V_LOADU
+#undef V_LOADA
+#undef V_STOREU
+#undef V_BCAST
+#undef V_MADD
+#undef V_ADD
+#endif
+
+#endif // GEMM_H
@@ -0,0 +1,299 @@
+/*
+ * gemm.h 的正确性检查与性能测试
+ * 1. 随机大小（含不足一个微内核块的边缘、跨越 KC/MC 分块的矩阵）与
+ *    multidim_array.c 的三重循环比较：int32_t 必须完全相同，浮点在舍入误差内
+ * 2. 64 到 4096 的方阵，三重循环、可移植内核、AVX2 内核（单线程和多线程）的 GFLOP/s
+ * 3. 转置：逐元素转置 与 缓存无关转置 的 GB/s
+ * 用法: ./gemm_bench [最大边长] [三重循环的最大边长] [线程数]
+ * C17/C18 标准
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "gemm.h"
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned rng_state = 2024;
+
+static unsigned next_random(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+// multidim_array.c 中的矩阵乘法（三种元素类型各一份）
+static void naive_multiply_i32(int rows_a, int cols_a, int32_t a[rows_a][cols_a],
+                               int rows_b, int cols_b, int32_t b[rows_b][cols_b],
+                               int32_t result[rows_a][cols_b]) {
+    for (int i = 0; i < rows_a; i++) {
+        for (int j = 0; j < cols_b; j++) {
+            result[i][j] = 0;
+            for (int k = 0; k < cols_a; k++) {
+                result[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+static void naive_multiply_f32(int rows_a, int cols_a, float a[rows_a][cols_a],
+                               int rows_b, int cols_b, float b[rows_b][cols_b],
+                               float result[rows_a][cols_b]) {
+    for (int i = 0; i < rows_a; i++) {
+        for (int j = 0; j < cols_b; j++) {
+            result[i][j] = 0;
+            for (int k = 0; k < cols_a; k++) {
+                result[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+static void naive_multiply_f64(int rows_a, int cols_a, double a[rows_a][cols_a],
+                               int rows_b, int cols_b, double b[rows_b][cols_b],
+                               double result[rows_a][cols_b]) {
+    for (int i = 0; i < rows_a; i++) {
+        for (int j = 0; j < cols_b; j++) {
+            result[i][j] = 0;
+            for (int k = 0; k < cols_a; k++) {
+                result[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+}
+
+// multidim_array.c 中的矩阵转置
+static void naive_transpose_f64(int rows, int cols, double matrix[rows][cols], double result[cols][rows]) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            result[j][i] = matrix[i][j];
+        }
+    }
+}
+
+enum { TYPE_I32, TYPE_F32, TYPE_F64, TYPE_N };
+
+static const char *const type_names[] = {"int32", "float", "double"};
+static const size_t type_sizes[] = {sizeof(int32_t), sizeof(float), sizeof(double)};
+
+// 整数取 [-8, 8]，乘加不会溢出；浮点取 [-1, 1]
+static void fill(int type, void *p, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int v = (int)(next_random() % 17) - 8;
+        switch (type) {
+        case TYPE_I32: ((int32_t *)p)[i] = v; break;
+        case TYPE_F32: ((float *)p)[i] = v / 8.0f; break;
+        case TYPE_F64: ((double *)p)[i] = v / 8.0 + (next_random() % 1000) * 1e-6; break;
+        }
+    }
+}
+
+static void run_naive(int type, size_t m, size_t n, size_t k, void *a, void *b, void *c) {
+    switch (type) {
+    case TYPE_I32: naive_multiply_i32((int)m, (int)k, a, (int)k, (int)n, b, c); break;
+    case TYPE_F32: naive_multiply_f32((int)m, (int)k, a, (int)k, (int)n, b, c); break;
+    case TYPE_F64: naive_multiply_f64((int)m, (int)k, a, (int)k, (int)n, b, c); break;
+    }
+}
+
+static int run_gemm(int type, size_t m, size_t n, size_t k, const void *a, const void *b, void *c) {
+    switch (type) {
+    case TYPE_I32: return gemm_i32(m, n, k, a, b, c);
+    case TYPE_F32: return gemm_f32(m, n, k, a, b, c);
+    default: return gemm_f64(m, n, k, a, b, c);
+    }
+}
+
+static double distance(double x, double y) {
+    return x > y ? x - y : y - x;
+}
+
+// 结果是否一致：整数逐个相等，浮点误差不超过 k 倍的机器精度
+static bool same_result(int type, const void *x, const void *y, size_t count, size_t k) {
+    for (size_t i = 0; i < count; i++) {
+        switch (type) {
+        case TYPE_I32:
+            if (((const int32_t *)x)[i] != ((const int32_t *)y)[i]) return false;
+            break;
+        case TYPE_F32:
+            if (distance(((const float *)x)[i], ((const float *)y)[i]) > (k + 1) * 1.2e-7) return false;
+            break;
+        case TYPE_F64:
+            if (distance(((const double *)x)[i], ((const double *)y)[i]) > (k + 1) * 2.3e-16) return false;
+            break;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static int check_correctness(void) {
+    int failures = 0, cases = 0;
+    int best = gemm_supported();
+    // 跨越 KC、MC 分块，且足以分给多个线程的大小
+    static const size_t large[][3] = {{300, 257, 513}, {97, 700, 300}, {145, 17, 1000}, {1, 1000, 1}};
+    for (int level = GEMM_PORTABLE; level <= best; level++) {
+        gemm_set_level(level);
+        for (int threads = 1; threads <= 4; threads += 3) {
+            gemm_set_threads(threads);
+            for (int t = 0; t < 130; t++) {
+                size_t m, n, k;
+                if (t < 4) {
+                    m = large[t][0], n = large[t][1], k = large[t][2];
+                } else {
+                    m = 1 + next_random() % 40, n = 1 + next_random() % 40, k = next_random() % 70;
+                }
+                for (int type = 0; type < TYPE_N; type++) {
+                    size_t es = type_sizes[type];
+                    void *a = malloc((m * k + 1) * es), *b = malloc((k * n + 1) * es);
+                    void *c = malloc(m * n * es), *ref = malloc(m * n * es);
+                    fill(type, a, m * k);
+                    fill(type, b, k * n);
+                    memset(c, 0x5a, m * n * es);   // 结果必须被完全覆盖
+                    run_naive(type, m, n, k, a, b, ref);
+                    cases++;
+                    if (run_gemm(type, m, n, k, a, b, c) != 0 || !same_result(type, c, ref, m * n, k)) {
+                        if (++failures <= 5) {
+                            printf("不一致: %s %s %d 线程 m=%zu n=%zu k=%zu\n", type_names[type],
+                                   gemm_level_name(level), threads, m, n, k);
+                        }
+                    }
+                    free(a);
+                    free(b);
+                    free(c);
+                    free(ref);
+                }
+            }
+        }
+    }
+    gemm_set_level(best);
+    gemm_set_threads(0);
+
+    for (int t = 0; t < 200; t++) {
+        size_t rows = 1 + next_random() % 200, cols = 1 + next_random() % 200;
+        double *src = malloc(rows * cols * sizeof(double));
+        double *x = malloc(rows * cols * sizeof(double)), *y = malloc(rows * cols * sizeof(double));
+        fill(TYPE_F64, src, rows * cols);
+        naive_transpose_f64((int)rows, (int)cols, (double (*)[cols])src, (double (*)[rows])x);
+        matrix_transpose_f64(rows, cols, src, y);
+        cases++;
+        if (memcmp(x, y, rows * cols * sizeof(double)) != 0 && ++failures <= 5) {
+            printf("转置不一致: %zu x %zu\n", rows, cols);
+        }
+        free(src);
+        free(x);
+        free(y);
+    }
+    printf("正确性检查: %d 组, %d 处不一致\n\n", cases, failures);
+    return failures;
+}
+
+// ---------------------------------------------------------------------------
+
+// 重复运行至少 0.3 秒（最多 3 次），返回最好一次的秒数；method < 0 为三重循环
+static double time_multiply(int type, int method, size_t n, void *a, void *b, void *c) {
+    double best = 1e30, total = 0;
+    for (int rep = 0; rep < 3 && (rep == 0 || total < 0.3); rep++) {
+        double t = now();
+        if (method < 0) run_naive(type, n, n, n, a, b, c);
+        else run_gemm(type, n, n, n, a, b, c);
+        t = now() - t;
+        total += t;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+static void bench_multiply(size_t max_n, size_t naive_max, int threads) {
+    int best = gemm_supported();
+    printf("矩阵乘法 C = A x B (GFLOP/s)，最高级别 %s，%d 线程\n", gemm_level_name(best), threads);
+    printf("%-7s %5s %10s %10s %10s %10s %8s\n", "类型", "边长", "三重循环", "portable",
+           gemm_level_name(best), "多线程", "加速比");
+    for (int type = 0; type < TYPE_N; type++) {
+        for (size_t n = 64; n <= max_n; n *= 2) {
+            size_t es = type_sizes[type];
+            void *a = malloc(n * n * es), *b = malloc(n * n * es);
+            void *c = malloc(n * n * es), *ref = malloc(n * n * es);
+            if (!a || !b || !c || !ref) {
+                printf("内存不足\n");
+                exit(1);
+            }
+            fill(type, a, n * n);
+            fill(type, b, n * n);
+            double flops = 2.0 * n * n * n;
+            double naive = 0;
+            bool ok = true;
+            if (n <= naive_max) {
+                naive = flops / time_multiply(type, -1, n, a, b, ref) / 1e9;
+            }
+
+            gemm_set_threads(1);
+            gemm_set_level(GEMM_PORTABLE);
+            double portable = flops / time_multiply(type, 0, n, a, b, c) / 1e9;
+            if (n <= naive_max) ok = ok && same_result(type, c, ref, n * n, n);
+            gemm_set_level(best);
+            double single = flops / time_multiply(type, 0, n, a, b, c) / 1e9;
+            if (n <= naive_max) ok = ok && same_result(type, c, ref, n * n, n);
+            gemm_set_threads(threads);
+            double multi = flops / time_multiply(type, 0, n, a, b, c) / 1e9;
+            if (n <= naive_max) ok = ok && same_result(type, c, ref, n * n, n);
+
+            printf("%-7s %5zu ", type_names[type], n);
+            if (n <= naive_max) printf("%10.2f", naive);
+            else printf("%10s", "-");
+            printf(" %10.2f %10.2f %10.2f", portable, single, multi);
+            if (n <= naive_max) printf(" %7.1fx", multi / naive);
+            printf("%s\n", ok ? "" : "  结果不一致!");
+            fflush(stdout);
+            free(a);
+            free(b);
+            free(c);
+            free(ref);
+        }
+    }
+    gemm_set_threads(0);
+}
+
+static void bench_transpose(size_t max_n) {
+    printf("\n矩阵转置 double (GB/s，读写各计一次)\n");
+    printf("%5s %10s %10s\n", "边长", "逐元素", "缓存无关");
+    for (size_t n = 64; n <= max_n; n *= 2) {
+        double *src = malloc(n * n * sizeof(double)), *dst = malloc(n * n * sizeof(double));
+        fill(TYPE_F64, src, n * n);
+        int reps = (int)(1e8 / (n * n)) + 1;
+        double best[2] = {1e30, 1e30};
+        for (int trial = 0; trial < 3; trial++) {
+            for (int method = 0; method < 2; method++) {
+                double t = now();
+                for (int r = 0; r < reps; r++) {
+                    if (method == 0) naive_transpose_f64((int)n, (int)n, (double (*)[n])src, (double (*)[n])dst);
+                    else matrix_transpose_f64(n, n, src, dst);
+                }
+                t = (now() - t) / reps;
+                if (t < best[method]) best[method] = t;
+            }
+        }
+        double bytes = 2.0 * n * n * sizeof(double);
+        printf("%5zu %10.2f %10.2f\n", n, bytes / best[0] / 1e9, bytes / best[1] / 1e9);
+        free(src);
+        free(dst);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t max_n = argc > 1 ? strtoull(argv[1], NULL, 10) : 4096;
+    size_t naive_max = argc > 2 ? strtoull(argv[2], NULL, 10) : 1024;
+    int threads = argc > 3 ? atoi(argv[3]) : gemm_threads();
+    if (threads < 1) threads = 1;
+
+    if (check_correctness() != 0) return 1;
+    bench_multiply(max_n, naive_max, threads);
+    bench_transpose(max_n);
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * gemm.h 的模板
+ * 本文件不单独使用：gemm.h 会包含它三次，每次先定义
+ *   T       元素类型，KSUF 函数名后缀（i32 / f32 / f64）
+ *   NR      微内核的列数（两个 256 位向量，即 64 字节）
+ *   KC MC NC  分块大小
+ *   K_MADD K_ADD  标量乘加和加法
+ * 以及 x86 上微内核用到的 VEC、V_* 基本操作宏。
+ * C17/C18 标准
+ */
+
+#define KCAT2(a, b) a##_##b
+#define KCAT(a, b) KCAT2(a, b)
+#define KNAME(name) KCAT(name, KSUF)
+
+// A 的 mc x kc 块按 MR 行一条打包：每条内按 k 方向排列，每个 k 连续存放 MR 个元素。
+// 不足 MR 行的部分补 0，微内核不需要处理边界
+static inline void KNAME(gemm_pack_a)(size_t mc, size_t kc, const T *a, size_t lda, T *dst) {
+    for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR) {
+        size_t rows = gemm_min(GEMM_MR, mc - i0);
+        for (size_t p = 0; p < kc; p++) {
+            for (size_t i = 0; i < rows; i++) dst[i] = a[(i0 + i) * lda + p];
+            for (size_t i = rows; i < GEMM_MR; i++) dst[i] = 0;
+            dst += GEMM_MR;
+        }
+    }
+}
+
+// B 的 kc x nc 块按 NR 列一条打包：每条内每个 k 连续存放 NR 个元素（正好 64 字节）
+static inline void KNAME(gemm_pack_b)(size_t kc, size_t nc, const T *b, size_t ldb, T *dst) {
+    for (size_t j0 = 0; j0 < nc; j0 += NR) {
+        size_t cols = gemm_min(NR, nc - j0);
+        for (size_t p = 0; p < kc; p++) {
+            memcpy(dst, b + p * ldb + j0, cols * sizeof(T));
+            for (size_t j = cols; j < NR; j++) dst[j] = 0;
+            dst += NR;
+        }
+    }
+}
+
+// 可移植的微内核：MR x NR 的结果块 = 打包的 A 条 x 打包的 B 条；
+// accumulate 为真时加到 c 上，否则覆盖。
+// 每次只算两行，累加器和一行 B 能放进 16 个 SSE 寄存器，编译器可以自动向量化
+static inline void KNAME(gemm_kernel_portable)(size_t kc, const T *restrict a, const T *restrict b,
+                                               T *restrict c, size_t ldc, bool accumulate) {
+    for (int i = 0; i < GEMM_MR; i += 2) {
+        T acc0[NR] = {0}, acc1[NR] = {0};
+        const T *ap = a + i, *bp = b;
+        for (size_t p = 0; p < kc; p++) {
+            for (int j = 0; j < NR; j++) {
+                acc0[j] = K_MADD(acc0[j], ap[0], bp[j]);
+                acc1[j] = K_MADD(acc1[j], ap[1], bp[j]);
+            }
+            ap += GEMM_MR;
+            bp += NR;
+        }
+        T *c0 = c + i * ldc, *c1 = c0 + ldc;
+        for (int j = 0; j < NR; j++) {
+            c0[j] = accumulate ? K_ADD(c0[j], acc0[j]) : acc0[j];
+            c1[j] = accumulate ? K_ADD(c1[j], acc1[j]) : acc1[j];
+        }
+    }
+}
+
+#ifdef GEMM_X86
+
+// AVX2 微内核：12 个累加寄存器（6 行 x 2 个向量），每个 k 读两个 B 向量、广播 6 个 A 元素
+#define KROW(i)                                                 \
+    do {                                                        \
+        VEC ai = V_BCAST(a + (i));                              \
+        c##i##0 = V_MADD(c##i##0, ai, b0);                      \
+        c##i##1 = V_MADD(c##i##1, ai, b1);                      \
+    } while (0)
+
+#define KSTORE(i)                                                               \
+    do {                                                                        \
+        T *ci = c + (i) * ldc;                                                  \
+        if (accumulate) {                                                       \
+            c##i##0 = V_ADD(c##i##0, V_LOADU(ci));                              \
+            c##i##1 = V_ADD(c##i##1, V_LOADU(ci + NR / 2));                     \
+        }                                                                       \
+        V_STOREU(ci, c##i##0);                                                  \
+        V_STOREU(ci + NR / 2, c##i##1);                                         \
+    } while (0)
+
+static inline __attribute__((target("avx2,fma"))) void
+KNAME(gemm_kernel_avx2)(size_t kc, const T *restrict a, const T *restrict b,
+                        T *restrict c, size_t ldc, bool accumulate) {
+    VEC c00 = V_ZERO(), c01 = V_ZERO(), c10 = V_ZERO(), c11 = V_ZERO();
+    VEC c20 = V_ZERO(), c21 = V_ZERO(), c30 = V_ZERO(), c31 = V_ZERO();
+    VEC c40 = V_ZERO(), c41 = V_ZERO(), c50 = V_ZERO(), c51 = V_ZERO();
+    for (size_t p = 0; p < kc; p++) {
+        VEC b0 = V_LOADA(b), b1 = V_LOADA(b + NR / 2);
+        KROW(0);
+        KROW(1);
+        KROW(2);
+        KROW(3);
+        KROW(4);
+        KROW(5);
+        a += GEMM_MR;
+        b += NR;
+    }
+    KSTORE(0);
+    KSTORE(1);
+    KSTORE(2);
+    KSTORE(3);
+    KSTORE(4);
+    KSTORE(5);
+}
+
+#undef KROW
+#undef KSTORE
+
+#endif // GEMM_X86
+
+// 一个线程的工作：C 的 m x n 子矩阵 = A 的 m 行 x B 的 n 列
+typedef struct {
+    size_t m, n, k;
+    const T *a, *b;
+    T *c;
+    size_t lda, ldb, ldc;
+    int level;
+    int status;             // 0 成功，-1 内存不足
+} KNAME(gemm_task);
+
+static inline void KNAME(gemm_run)(KNAME(gemm_task) *t) {
+    const size_t m = t->m, n = t->n, k = t->k, lda = t->lda, ldb = t->ldb, ldc = t->ldc;
+    size_t pa_size = gemm_round_up(gemm_min(MC, gemm_round_up(m, GEMM_MR)) * gemm_min(KC, k) * sizeof(T), GEMM_ALIGN);
+    size_t pb_size = gemm_round_up(gemm_min(NC, gemm_round_up(n, NR)) * gemm_min(KC, k) * sizeof(T), GEMM_ALIGN);
+    T *pa = aligned_alloc(GEMM_ALIGN, pa_size);
+    T *pb = aligned_alloc(GEMM_ALIGN, pb_size);
+    if (!pa || !pb) {
+        free(pa);
+        free(pb);
+        t->status = -1;
+        return;
+    }
+
+    void (*kernel)(size_t, const T *restrict, const T *restrict, T *restrict, size_t, bool) =
+        KNAME(gemm_kernel_portable);
+#ifdef GEMM_X86
+    if (t->level == GEMM_AVX2) kernel = KNAME(gemm_kernel_avx2);
+#endif
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = gemm_min(NC, n - jc);
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = gemm_min(KC, k - pc);
+            KNAME(gemm_pack_b)(kc, nc, t->b + pc * ldb + jc, ldb, pb);
+            for (size_t ic = 0; ic < m; ic += MC) {
+                size_t mc = gemm_min(MC, m - ic);
+                KNAME(gemm_pack_a)(mc, kc, t->a + ic * lda + pc, lda, pa);
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    size_t nr = gemm_min(NR, nc - jr);
+                    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+                        size_t mr = gemm_min(GEMM_MR, mc - ir);
+                        T *c = t->c + (ic + ir) * ldc + jc + jr;
+                        if (mr == GEMM_MR && nr == NR) {
+                            kernel(kc, pa + ir * kc, pb + jr * kc, c, ldc, pc > 0);
+                            continue;
+                        }
+                        // 边缘不完整的块：先算到临时块里，再把有效部分写回
+                        _Alignas(GEMM_ALIGN) T tile[GEMM_MR * NR];
+                        kernel(kc, pa + ir * kc, pb + jr * kc, tile, NR, false);
+                        for (size_t i = 0; i < mr; i++) {
+                            for (size_t j = 0; j < nr; j++) {
+                                c[i * ldc + j] = pc > 0 ? K_ADD(c[i * ldc + j], tile[i * NR + j]) : tile[i * NR + j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    free(pa);
+    free(pb);
+    t->status = 0;
+}
+
+static inline void *KNAME(gemm_thread)(void *arg) {
+    KNAME(gemm_run)(arg);
+    return NULL;
+}
+
+// C (m x n) = A (m x k) x B (k x n)，行优先连续存储；成功返回 0，内存不足返回 -1
+static inline int KNAME(gemm)(size_t m, size_t n, size_t k, const T *a, const T *b, T *c) {
+    if (m == 0 || n == 0) return 0;
+    if (k == 0) {
+        for (size_t i = 0; i < m * n; i++) c[i] = 0;
+        return 0;
+    }
+
+    // 沿较长的一边切分，每份是 MR 行（或 NR 列）的整数倍，每个线程至少 GEMM_MIN_WORK 次乘加
+    bool by_rows = m >= n;
+    size_t unit = by_rows ? GEMM_MR : NR;
+    size_t units = (by_rows ? gemm_round_up(m, GEMM_MR) : gemm_round_up(n, NR)) / unit;
+    double work = (double)m * n * k;
+    size_t threads = (size_t)gemm_threads();
+    if (threads > units) threads = units;
+    if (threads > work / GEMM_MIN_WORK) threads = (size_t)(work / GEMM_MIN_WORK);
+    if (threads < 1) threads = 1;
+
+    KNAME(gemm_task) tasks[GEMM_MAX_THREADS];
+    pthread_t ids[GEMM_MAX_THREADS];
+    bool started[GEMM_MAX_THREADS] = {false};
+    int level = gemm_level();
+    for (size_t t = 0; t < threads; t++) {
+        size_t lo = units * t / threads * unit, hi = units * (t + 1) / threads * unit;
+        size_t total = by_rows ? m : n;
+        if (hi > total) hi = total;
+        KNAME(gemm_task) task = {
+            .m = by_rows ? hi - lo : m, .n = by_rows ? n : hi - lo, .k = k,
+            .a = by_rows ? a + lo * k : a, .b = by_rows ? b : b + lo,
+            .c = by_rows ? c + lo * n : c + lo,
+            .lda = k, .ldb = n, .ldc = n, .level = level, .status = 0,
+        };
+        tasks[t] = task;
+    }
+    // 第 0 份在当前线程计算；无法创建线程时也在当前线程计算
+    for (size_t t = 1; t < threads; t++) {
+        started[t] = pthread_create(&ids[t], NULL, KNAME(gemm_thread), &tasks[t]) == 0;
+    }
+    KNAME(gemm_run)(&tasks[0]);
+    int status = tasks[0].status;
+    for (size_t t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(ids[t], NULL);
+        else KNAME(gemm_run)(&tasks[t]);
+        if (tasks[t].status != 0) status = -1;
+    }
+    return status;
+}
+
+// 缓存无关转置：总是把较长的一边对半分，直到块小到可以放进 L1，
+// 不需要知道缓存大小，每一级缓存都能被充分利用
+static inline void KNAME(transpose_block)(size_t rows, size_t cols, const T *src, size_t lds,
+                                          T *dst, size_t ldd) {
+    if (rows <= GEMM_TRANSPOSE_LEAF && cols <= GEMM_TRANSPOSE_LEAF) {
+        // 按 dst 的行顺序写，写入是连续的
+        for (size_t j = 0; j < cols; j++) {
+            for (size_t i = 0; i < rows; i++) dst[j * ldd + i] = src[i * lds + j];
+        }
+    } else if (rows >= cols) {
+        size_t half = rows / 2;
+        KNAME(transpose_block)(half, cols, src, lds, dst, ldd);
+        KNAME(transpose_block)(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+    } else {
+        size_t half = cols / 2;
+        KNAME(transpose_block)(rows, half, src, lds, dst, ldd);
+        KNAME(transpose_block)(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+    }
+}
+
+// dst (cols x rows) = src (rows x cols) 的转置，两者不能重叠
+static inline void KNAME(matrix_transpose)(size_t rows, size_t cols, const T *src, T *dst) {
+    KNAME(transpose_block)(rows, cols, src, cols, dst, rows);
+}
+
+#undef KNAME
+#undef KCAT
+#undef KCAT2
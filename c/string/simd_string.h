@@ -0,0 +1,345 @@
+/*
+ * SIMD 字符串处理函数
+ * string_manipulation.c 中七个逐字节函数的向量化版本，结果与原函数相同：
+ *   simd_count_occurrences  simd_string_replace  simd_string_reverse  simd_trim
+ *   simd_count_words        simd_is_palindrome   simd_split_string
+ * 每次调用按 CPU 支持的指令集选择实现（x86 上为 AVX2 或 SSE2，
+ * 其他平台为标量版本），也可以用 simd_string_set_level 手动指定。
+ * count_occurrences 只有单字节子串使用向量内核，其余仍调用 strstr。
+ * 所有函数只包含在本头文件中，直接 #include 即可使用。
+ * C17/C18 标准
+ *
+ * 与原函数的差别：
+ *   - 空白与大小写按 "C" 区域设置处理（程序没有调用 setlocale 时与原函数一致）
+ *   - count_occurrences 的 substr 为空串时原函数不会返回，这里返回 0
+ *   - split_string 原函数把 &delimiter 当作字符串传给 strtok（没有 '\0' 结尾），
+ *     标量版本改为传入真正的单字符字符串，其余行为不变
+ */
+
+#ifndef SIMD_STRING_H
+#define SIMD_STRING_H
+
+#include <ctype.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_STRING_X86 1
+#endif
+
+// 对齐读取可能读到字符串末尾之后（不会跨页），AddressSanitizer 需要忽略这些函数
+#if defined(__SANITIZE_ADDRESS__)
+#define SIMD_NO_ASAN __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SIMD_NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef SIMD_NO_ASAN
+#define SIMD_NO_ASAN
+#endif
+
+enum { SIMD_SCALAR = 0, SIMD_SSE2 = 1, SIMD_AVX2 = 2 };
+
+static inline bool simd_is_space(char c) {
+    return c == ' ' || (unsigned char)(c - '\t') < 5;
+}
+
+static inline char simd_lower_ascii(char c) {
+    return (unsigned char)(c - 'A') < 26 ? (char)(c | 0x20) : c;
+}
+
+// ---------------------------------------------------------------------------
+// 标量版本：string_manipulation.c 中的原始循环
+
+static inline void scalar_string_replace(char *str, char old_char, char new_char) {
+    for (int i = 0; str[i]; i++) {
+        if (str[i] == old_char) {
+            str[i] = new_char;
+        }
+    }
+}
+
+static inline void scalar_string_reverse(char *str) {
+    size_t len = strlen(str);
+    for (size_t i = 0; i < len / 2; i++) {
+        char temp = str[i];
+        str[i] = str[len - 1 - i];
+        str[len - 1 - i] = temp;
+    }
+}
+
+static inline bool scalar_is_palindrome(const char *str) {
+    size_t len = strlen(str);
+    for (size_t i = 0; i < len / 2; i++) {
+        if (tolower(str[i]) != tolower(str[len - 1 - i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline char *scalar_trim(char *str) {
+    while (isspace((unsigned char)*str)) str++;
+
+    if (*str == '\0') return str;
+
+    char *end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end)) end--;
+
+    *(end + 1) = '\0';
+    return str;
+}
+
+static inline int scalar_count_words(const char *str) {
+    int count = 0;
+    bool in_word = false;
+
+    while (*str) {
+        if (isspace((unsigned char)*str)) {
+            in_word = false;
+        } else if (!in_word) {
+            in_word = true;
+            count++;
+        }
+        str++;
+    }
+
+    return count;
+}
+
+static inline int scalar_split_string(char *str, char delimiter, char **tokens, int max_tokens) {
+    int count = 0;
+    const char delim[2] = {delimiter, '\0'};
+    char *token = strtok(str, delim);
+
+    while (token != NULL && count < max_tokens) {
+        tokens[count++] = token;
+        token = strtok(NULL, delim);
+    }
+
+    return count;
+}
+
+static inline int scalar_count_occurrences(const char *str, const char *substr) {
+    int count = 0;
+    const char *pos = str;
+    size_t substr_len = strlen(substr);
+
+    if (substr_len == 0) return 0;
+    while ((pos = strstr(pos, substr)) != NULL) {
+        count++;
+        pos += substr_len;
+    }
+
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// 向量版本
+
+#ifdef SIMD_STRING_X86
+
+// SSE2：x86-64 上总是可用
+#define KSUF sse2
+#define KATTR
+#define VEC __m128i
+#define W 16
+#define V_LOADU(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define V_LOADA(p) _mm_load_si128((const __m128i *)(const void *)(p))
+#define V_STOREU(p, v) _mm_storeu_si128((__m128i *)(void *)(p), (v))
+#define V_STOREA(p, v) _mm_store_si128((__m128i *)(void *)(p), (v))
+#define V_SET1(c) _mm_set1_epi8((char)(c))
+#define V_CMPEQ(a, b) _mm_cmpeq_epi8((a), (b))
+#define V_SUB(a, b) _mm_sub_epi8((a), (b))
+#define V_MINU(a, b) _mm_min_epu8((a), (b))
+#define V_OR(a, b) _mm_or_si128((a), (b))
+#define V_AND(a, b) _mm_and_si128((a), (b))
+#define V_ANDNOT(a, b) _mm_andnot_si128((a), (b))
+#define V_MOVEMASK(v) _mm_movemask_epi8(v)
+#define V_REVERSE(v) simd_reverse_sse2(v)
+
+// SSE2 没有字节重排指令：先反转 32 位元素，再交换 16 位和 8 位
+static inline __m128i simd_reverse_sse2(__m128i v) {
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+#include "simd_string_kernels.h"
+
+#undef KSUF
+#undef KATTR
+#undef VEC
+#undef W
+#undef V_LOADU
+#undef V_LOADA
+#undef V_STOREU
+#undef V_STOREA
+#undef V_SET1
+#undef V_CMPEQ
+#undef V_SUB
+#undef V_MINU
+#undef V_OR
+#undef V_AND
+#undef V_ANDNOT
+#undef V_MOVEMASK
+#undef V_REVERSE
+
+// AVX2：用 target 属性单独编译，运行时确认 CPU 支持后才调用
+#define KSUF avx2
+#define KATTR __attribute__((target("avx2")))
+#define VEC __m256i
+#define W 32
+#define V_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define V_LOADA(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#define V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define V_STOREA(p, v) _mm256_store_si256((__m256i *)(void *)(p), (v))
+#define V_SET1(c) _mm256_set1_epi8((char)(c))
+#define V_CMPEQ(a, b) _mm256_cmpeq_epi8((a), (b))
+#define V_SUB(a, b) _mm256_sub_epi8((a), (b))
+#define V_MINU(a, b) _mm256_min_epu8((a), (b))
+#define V_OR(a, b) _mm256_or_si256((a), (b))
+#define V_AND(a, b) _mm256_and_si256((a), (b))
+#define V_ANDNOT(a, b) _mm256_andnot_si256((a), (b))
+#define V_MOVEMASK(v) _mm256_movemask_epi8(v)
+#define V_REVERSE(v) simd_reverse_avx2(v)
+
+static inline __attribute__((target("avx2"))) __m256i simd_reverse_avx2(__m256i v) {
+    const __m256i rev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    v = _mm256_shuffle_epi8(v, rev);
+    return _mm256_permute2x128_si256(v, v, 1);
+}
+
+#include "simd_string_kernels.h"
+
+#undef KSUF
+#undef KATTR
+#undef VEC
+#undef W
+#undef V_LOADU
+#undef V_LOADA
+#undef V_STOREU
+#undef V_STOREA
+#undef V_SET1
+#undef V_CMPEQ
+#undef V_SUB
+#undef V_MINU
+#undef V_OR
+#undef V_AND
+#undef V_ANDNOT
+#undef V_MOVEMASK
+#undef V_REVERSE
+
+#endif // SIMD_STRING_X86
+
+// ---------------------------------------------------------------------------
+// 运行时选择
+
+// CPU 支持的最高级别
+static inline int simd_string_supported(void) {
+#ifdef SIMD_STRING_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+static inline atomic_int *simd_string_level_slot(void) {
+    static atomic_int level = -1;
+    return &level;
+}
+
+// 当前使用的级别；第一次调用时检测 CPU
+static inline int simd_string_level(void) {
+    int level = atomic_load_explicit(simd_string_level_slot(), memory_order_relaxed);
+    if (level < 0) {
+        level = simd_string_supported();
+        atomic_store_explicit(simd_string_level_slot(), level, memory_order_relaxed);
+    }
+    return level;
+}
+
+// 指定级别（超过 CPU 支持的级别时取支持的最高级别），返回实际使用的级别
+static inline int simd_string_set_level(int level) {
+    int best = simd_string_supported();
+    if (level > best) level = best;
+    if (level < SIMD_SCALAR) level = SIMD_SCALAR;
+    atomic_store_explicit(simd_string_level_slot(), level, memory_order_relaxed);
+    return level;
+}
+
+static inline const char *simd_string_level_name(int level) {
+    static const char *const names[] = {"scalar", "SSE2", "AVX2"};
+    return names[level];
+}
+
+// 有返回值的函数用 SIMD_DISPATCH，void 函数用 SIMD_DISPATCH_VOID
+// （C17 6.8.6.4：void 函数中不能出现带表达式的 return）
+#ifdef SIMD_STRING_X86
+#define SIMD_DISPATCH(name, ...)                                    \
+    switch (simd_string_level()) {                                  \
+    case SIMD_AVX2: return name##_avx2(__VA_ARGS__);                \
+    case SIMD_SSE2: return name##_sse2(__VA_ARGS__);                \
+    default: return scalar_##name(__VA_ARGS__);                     \
+    }
+#define SIMD_DISPATCH_VOID(name, ...)                               \
+    switch (simd_string_level()) {                                  \
+    case SIMD_AVX2: name##_avx2(__VA_ARGS__); return;               \
+    case SIMD_SSE2: name##_sse2(__VA_ARGS__); return;               \
+    default: scalar_##name(__VA_ARGS__); return;                    \
+    }
+#else
+#define SIMD_DISPATCH(name, ...) return scalar_##name(__VA_ARGS__);
+#define SIMD_DISPATCH_VOID(name, ...) scalar_##name(__VA_ARGS__);
+#endif
+
+// 统计 substr 在 str 中不重叠出现的次数
+// glibc 的 strstr 本身已经向量化（按子串前两个字节筛选），多字节子串的内核在常见输入上
+// 最多与它持平，短字符串还要多付检测的开销，所以只有单字节子串使用向量内核
+static inline int simd_count_occurrences(const char *str, const char *substr) {
+    if (substr[0] == '\0' || substr[1] != '\0') return scalar_count_occurrences(str, substr);
+    SIMD_DISPATCH(count_occurrences, str, substr)
+}
+
+// 把 str 中所有 old_char 替换为 new_char
+static inline void simd_string_replace(char *str, char old_char, char new_char) {
+    SIMD_DISPATCH_VOID(string_replace, str, old_char, new_char)
+}
+
+// 原地反转 str
+static inline void simd_string_reverse(char *str) {
+    SIMD_DISPATCH_VOID(string_reverse, str)
+}
+
+// 去除首尾空白，返回 str 中第一个非空白字符的位置
+static inline char *simd_trim(char *str) {
+    SIMD_DISPATCH(trim, str)
+}
+
+// 统计由空白分隔的单词数
+static inline int simd_count_words(const char *str) {
+    SIMD_DISPATCH(count_words, str)
+}
+
+// 忽略 ASCII 大小写判断 str 是否为回文
+static inline bool simd_is_palindrome(const char *str) {
+    SIMD_DISPATCH(is_palindrome, str)
+}
+
+// 按 delimiter 分割 str（会修改 str），最多保存 max_tokens 个记号
+static inline int simd_split_string(char *str, char delimiter, char **tokens, int max_tokens) {
+    SIMD_DISPATCH(split_string, str, delimiter, tokens, max_tokens)
+}
+
+#undef SIMD_DISPATCH
+#undef SIMD_DISPATCH_VOID
+
+#endif // SIMD_STRING_H
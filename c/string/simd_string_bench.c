@@ -0,0 +1,139 @@
+/*
+ * simd_string.h 的性能测试
+ * 对 16 B 到 16 MB 的文本，分别用标量、SSE2、AVX2 版本运行七个函数，
+ * 以 GB/s（每秒处理的输入字节数）报告。
+ * 用法: ./simd_string_bench [最大字节数]
+ * C17/C18 标准
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "simd_string.h"
+
+#define MAX_TOKENS (1 << 22)
+
+static char *text;          // 测试输入，可被修改
+static char *original;      // 未修改的副本
+static char *palindrome;    // 回文，is_palindrome 必须检查全部字节
+static char **tokens;
+static size_t text_len;
+static volatile long sink;
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 由单词、空格和逗号组成的文本，首尾各有 1/8 的空白
+static void make_text(size_t len) {
+    static const char *const words[] = {
+        "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "Hello",
+        "World", "string", "simd", "vector", "a", "benchmark", "of", "C17"
+    };
+    unsigned seed = 12345;
+    size_t n = 0;
+    while (n < len) {
+        seed = seed * 1103515245u + 12345u;
+        const char *w = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        for (; *w && n < len; w++) original[n++] = *w;
+        if (n < len) original[n++] = (seed >> 8) % 5 ? ' ' : ',';
+    }
+    for (size_t i = 0; i < len / 8; i++) {
+        original[i] = original[len - 1 - i] = " \t\n"[i % 3];
+    }
+    original[len] = '\0';
+    for (size_t i = 0; i < len; i++) {
+        palindrome[i] = original[i < len / 2 ? i : len - 1 - i];
+    }
+    palindrome[len] = '\0';
+}
+
+static void restore(void) {
+    memcpy(text, original, text_len + 1);
+}
+
+enum { F_COUNT, F_REPLACE, F_REVERSE, F_TRIM, F_WORDS, F_PALINDROME, F_SPLIT, F_RESTORE, F_N };
+
+static const char *const function_names[] = {
+    "count_occurrences", "string_replace", "string_reverse", "trim",
+    "count_words", "is_palindrome", "split_string"
+};
+
+static void run(int f, int rep) {
+    switch (f) {
+    case F_COUNT: sink += simd_count_occurrences(text, "needle"); break;
+    case F_REPLACE:
+        if (rep % 2) simd_string_replace(text, 'o', '0');
+        else simd_string_replace(text, '0', 'o');
+        break;
+    case F_REVERSE: simd_string_reverse(text); break;
+    case F_TRIM:
+        restore();
+        sink += simd_trim(text) - text;
+        break;
+    case F_WORDS: sink += simd_count_words(text); break;
+    case F_PALINDROME: sink += simd_is_palindrome(palindrome); break;
+    case F_SPLIT:
+        restore();
+        sink += simd_split_string(text, ',', tokens, MAX_TOKENS);
+        break;
+    case F_RESTORE: restore(); break;
+    }
+}
+
+// 最好的一次，秒/调用；每次测量处理约 32 MB
+static double time_function(int f) {
+    long reps = (long)(32e6 / (text_len + 1)) + 1;
+    double best = 1e30;
+    for (int trial = 0; trial < 3; trial++) {
+        restore();
+        double t = now();
+        for (long r = 0; r < reps; r++) run(f, (int)r);
+        t = (now() - t) / reps;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    size_t max_len = argc > 1 ? strtoull(argv[1], NULL, 10) : (16u << 20);
+    text = malloc(max_len + 1);
+    original = malloc(max_len + 1);
+    palindrome = malloc(max_len + 1);
+    tokens = malloc(MAX_TOKENS * sizeof(char *));
+    if (!text || !original || !palindrome || !tokens) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+
+    int best = simd_string_supported();
+    printf("SIMD 字符串函数性能 (GB/s)\n");
+    printf("%-18s %9s", "函数", "字节");
+    for (int level = SIMD_SCALAR; level <= best; level++) printf(" %8s", simd_string_level_name(level));
+    printf("\n");
+
+    for (int f = 0; f < F_RESTORE; f++) {
+        for (size_t len = 16; len <= max_len; len *= 4) {
+            text_len = len;
+            make_text(len);
+            printf("%-18s %9zu", function_names[f], len);
+            for (int level = SIMD_SCALAR; level <= best; level++) {
+                simd_string_set_level(level);
+                double t = time_function(f);
+                // trim 和 split_string 每次都要先恢复输入，扣除这部分时间
+                if (f == F_TRIM || f == F_SPLIT) t -= time_function(F_RESTORE);
+                printf(" %8.2f", len / t / 1e9);
+            }
+            printf("\n");
+        }
+    }
+
+    free(text);
+    free(original);
+    free(palindrome);
+    free(tokens);
+    return 0;
+}
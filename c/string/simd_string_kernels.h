@@ -0,0 +1,183 @@
+/*
+ * simd_string.h 的向量内核模板
+ * 本文件不单独使用：simd_string.h 会包含它两次，每次先定义
+ *   KSUF  函数名后缀（sse2 / avx2）
+ *   KATTR 函数属性（目标指令集）
+ *   VEC   向量类型，W 为字节宽度
+ * 以及下面用到的 V_* 基本操作宏。
+ * C17/C18 标准
+ */
+
+#define KCAT2(a, b) a##_##b
+#define KCAT(a, b) KCAT2(a, b)
+#define KNAME(name) KCAT(name, KSUF)
+
+// 低 W 位全为 1 的掩码
+#define KFULL ((uint64_t)((W == 32) ? 0xFFFFFFFFu : 0xFFFFu))
+
+// 空白字符：' ' 以及 '\t' '\n' '\v' '\f' '\r'（"C" 区域设置下的 isspace）
+static inline KATTR VEC KNAME(is_space)(VEC v) {
+    VEC d = V_SUB(v, V_SET1('\t'));
+    return V_OR(V_CMPEQ(v, V_SET1(' ')),
+                V_CMPEQ(V_MINU(d, V_SET1(4)), d));
+}
+
+// ASCII 大写转小写，其余字节不变（"C" 区域设置下的 tolower）
+static inline KATTR VEC KNAME(to_lower)(VEC v) {
+    VEC d = V_SUB(v, V_SET1('A'));
+    VEC upper = V_CMPEQ(V_MINU(d, V_SET1(25)), d);
+    return V_OR(v, V_AND(upper, V_SET1(0x20)));
+}
+
+// 字符串替换：对齐读取，整块都在字符串内时才写回
+static inline KATTR SIMD_NO_ASAN void KNAME(string_replace)(char *str, char old_char, char new_char) {
+    if (old_char == '\0') return;
+    char *p = str;
+    while ((uintptr_t)p % W != 0) {
+        if (*p == '\0') return;
+        if (*p == old_char) *p = new_char;
+        p++;
+    }
+    const VEC zero = V_SET1(0), from = V_SET1(old_char), to = V_SET1(new_char);
+    for (;; p += W) {
+        VEC v = V_LOADA(p);
+        if (V_MOVEMASK(V_CMPEQ(v, zero))) break;
+        VEC hit = V_CMPEQ(v, from);
+        if (V_MOVEMASK(hit)) V_STOREA(p, V_OR(V_AND(hit, to), V_ANDNOT(hit, v)));
+    }
+    for (; *p; p++) {
+        if (*p == old_char) *p = new_char;
+    }
+}
+
+// 字符串反转：首尾各取一块，块内反转后交换
+static inline KATTR void KNAME(string_reverse)(char *str) {
+    char *lo = str, *hi = str + strlen(str);
+    while (hi - lo >= 2 * W) {
+        VEC a = V_LOADU(lo), b = V_LOADU(hi - W);
+        V_STOREU(lo, V_REVERSE(b));
+        V_STOREU(hi - W, V_REVERSE(a));
+        lo += W;
+        hi -= W;
+    }
+    while (hi - lo > 1) {
+        char temp = *lo;
+        *lo++ = *--hi;
+        *hi = temp;
+    }
+}
+
+// 回文检查：首块与反转后的尾块逐字节比较（忽略 ASCII 大小写）
+static inline KATTR bool KNAME(is_palindrome)(const char *str) {
+    const char *lo = str, *hi = str + strlen(str);
+    while (hi - lo >= 2 * W) {
+        VEC a = KNAME(to_lower)(V_LOADU(lo));
+        VEC b = V_REVERSE(KNAME(to_lower)(V_LOADU(hi - W)));
+        if ((uint32_t)V_MOVEMASK(V_CMPEQ(a, b)) != KFULL) return false;
+        lo += W;
+        hi -= W;
+    }
+    while (hi - lo > 1) {
+        hi--;
+        if (simd_lower_ascii(*lo) != simd_lower_ascii(*hi)) return false;
+        lo++;
+    }
+    return true;
+}
+
+// 字符串修剪：整块跳过前导空白，再从尾部整块向前找最后一个非空白
+static inline KATTR char *KNAME(trim)(char *str) {
+    char *end = str + strlen(str);
+    while (end - str >= W) {
+        uint64_t solid = ~(uint64_t)(uint32_t)V_MOVEMASK(KNAME(is_space)(V_LOADU(str))) & KFULL;
+        if (solid) break;
+        str += W;
+    }
+    while (simd_is_space(*str)) str++;
+    if (*str == '\0') return str;
+
+    // str[0] 不是空白，所以只需检查 (str, end)
+    while (end - (str + 1) >= W) {
+        uint64_t solid = ~(uint64_t)(uint32_t)V_MOVEMASK(KNAME(is_space)(V_LOADU(end - W))) & KFULL;
+        if (solid) {
+            end -= W - (63 - __builtin_clzll(solid)) - 1;
+            *end = '\0';
+            return str;
+        }
+        end -= W;
+    }
+    while (end > str + 1 && simd_is_space(end[-1])) end--;
+    *end = '\0';
+    return str;
+}
+
+// 单词计数：非空白字节且前一个字节是空白，即为一个单词的开头
+static inline KATTR SIMD_NO_ASAN int KNAME(count_words)(const char *str) {
+    const char *p = (const char *)((uintptr_t)str & ~(uintptr_t)(W - 1));
+    const unsigned skip = (unsigned)(str - p);
+    const uint64_t before = ((uint64_t)1 << skip) - 1;  // str 之前的字节
+    const VEC zero = V_SET1(0);
+    uint64_t carry = 1;                                 // str 之前视为空白
+    int count = 0;
+    for (uint64_t head = before;; p += W, head = 0) {
+        VEC v = V_LOADA(p);
+        uint64_t nul = (uint32_t)V_MOVEMASK(V_CMPEQ(v, zero)) & ~head;
+        uint64_t space = (uint32_t)V_MOVEMASK(KNAME(is_space)(v)) | head;
+        if (nul) space |= ~((nul & -nul) - 1);          // '\0' 及之后都不算
+        count += __builtin_popcountll(~space & ((space << 1) | carry) & KFULL);
+        if (nul) return count;
+        carry = space >> (W - 1) & 1;
+    }
+}
+
+// 查找第一个等于 c 或 '\0' 的字节（即 strchrnul）
+static inline KATTR SIMD_NO_ASAN char *KNAME(find_char_or_nul)(char *s, char c) {
+    char *p = (char *)((uintptr_t)s & ~(uintptr_t)(W - 1));
+    const unsigned skip = (unsigned)(s - p);
+    const VEC zero = V_SET1(0), want = V_SET1(c);
+    VEC v = V_LOADA(p);
+    uint64_t hit = (uint32_t)V_MOVEMASK(V_OR(V_CMPEQ(v, zero), V_CMPEQ(v, want))) >> skip << skip;
+    while (!hit) {
+        p += W;
+        v = V_LOADA(p);
+        hit = (uint32_t)V_MOVEMASK(V_OR(V_CMPEQ(v, zero), V_CMPEQ(v, want)));
+    }
+    return p + __builtin_ctzll(hit);
+}
+
+// 字符串分割：与用单字符分隔符调用 strtok 的结果完全相同
+static inline KATTR int KNAME(split_string)(char *str, char delimiter, char **tokens, int max_tokens) {
+    int count = 0;
+    char *p = str;
+    for (;;) {
+        while (delimiter != '\0' && *p == delimiter) p++;
+        if (*p == '\0') return count;
+        char *token = p;
+        p = KNAME(find_char_or_nul)(p + 1, delimiter);
+        if (*p != '\0') *p++ = '\0';
+        // strtok 版本在返回之前已经多取了一个记号，这里同样把它截断
+        if (count >= max_tokens) return count;
+        tokens[count++] = token;
+    }
+}
+
+// 子字符串计数，只用于单字节子串（见 simd_count_occurrences）：不重叠出现的次数就是
+// '\0' 之前等于 substr[0] 的字节数，按对齐块统计，不需要先求 strlen(str)
+static inline KATTR SIMD_NO_ASAN int KNAME(count_occurrences)(const char *str, const char *substr) {
+    const char *p = (const char *)((uintptr_t)str & ~(uintptr_t)(W - 1));
+    const VEC zero = V_SET1(0), c = V_SET1(substr[0]);
+    uint64_t keep = KFULL << (str - p);                 // 去掉 str 之前的字节
+    int count = 0;
+    for (;; p += W, keep = KFULL) {
+        VEC v = V_LOADA(p);
+        uint64_t nul = (uint32_t)V_MOVEMASK(V_CMPEQ(v, zero)) & keep;
+        uint64_t hit = (uint32_t)V_MOVEMASK(V_CMPEQ(v, c)) & keep;
+        if (nul) return count + __builtin_popcountll(hit & ((nul & -nul) - 1));
+        count += __builtin_popcountll(hit);
+    }
+}
+
+#undef KFULL
+#undef KNAME
+#undef KCAT
+#undef KCAT2
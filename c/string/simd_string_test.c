@@ -0,0 +1,285 @@
+/*
+ * simd_string.h 的差分测试
+ * 对 CPU 支持的每个向量级别，把七个函数的返回值和修改后的整个缓冲区
+ * 与标量版本逐一比较：所有长度 0..200、所有起始对齐、多种字符集、
+ * 全部 256x256 种替换字符、全部分隔符，以及紧贴不可访问页的字符串。
+ * C17/C18 标准
+ */
+
+#define _DEFAULT_SOURCE     // MAP_ANON
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "simd_string.h"
+
+#define BUF_SIZE 512
+#define MAX_LEN 200
+#define MAX_TOKENS 300
+
+static long checks = 0;
+static long failures = 0;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fail(const char *what, const char *input, size_t len) {
+    if (++failures <= 10) {
+        printf("不一致: %s, 长度 %zu, 输入:", what, len);
+        for (size_t i = 0; i < len && i < 48; i++) printf(" %02x", (unsigned char)input[i]);
+        printf("\n");
+    }
+}
+
+// 字符集：空白为主、大小写混合、分隔符为主、任意非零字节
+static const char *const alphabets[] = {
+    " a",
+    " \t\n\v\f\rxY",
+    "aAbB",
+    ",,x",
+    NULL,   // 1..255
+};
+
+static void fill(char *s, size_t len, const char *alphabet) {
+    size_t k = alphabet ? strlen(alphabet) : 0;
+    for (size_t i = 0; i < len; i++) {
+        s[i] = alphabet ? alphabet[next_random() % k] : (char)(1 + next_random() % 255);
+    }
+    s[len] = '\0';
+}
+
+// 一半随机，另一半镜像并随机改变大小写；偶尔改坏一个字节
+static void fill_palindrome(char *s, size_t len, const char *alphabet) {
+    fill(s, len, alphabet);
+    for (size_t i = 0; i < len / 2; i++) {
+        char c = s[i];
+        if (next_random() % 2 && (unsigned char)((c | 0x20) - 'a') < 26) c ^= 0x20;
+        s[len - 1 - i] = c;
+    }
+    if (len > 1 && next_random() % 4 == 0) s[next_random() % len] ^= 1;
+}
+
+// 在 str 上运行除 replace/split 以外的全部函数，与标量版本比较
+static void check_string(const char *str, size_t len) {
+    static char a[BUF_SIZE], b[BUF_SIZE];
+
+    checks++;
+    if (simd_count_words(str) != scalar_count_words(str)) fail("count_words", str, len);
+    if (simd_is_palindrome(str) != scalar_is_palindrome(str)) fail("is_palindrome", str, len);
+
+    memcpy(a, str, len + 1);
+    memcpy(b, str, len + 1);
+    simd_string_reverse(a);
+    scalar_string_reverse(b);
+    if (memcmp(a, b, len + 1) != 0) fail("string_reverse", str, len);
+
+    memcpy(a, str, len + 1);
+    memcpy(b, str, len + 1);
+    if (simd_trim(a) - a != scalar_trim(b) - b || memcmp(a, b, len + 1) != 0) fail("trim", str, len);
+
+    // 子串取自 str 本身（保证能找到）和随机位置
+    for (int k = 0; k < 4; k++) {
+        char needle[64];
+        size_t start = len ? next_random() % len : 0;
+        size_t m = 1 + next_random() % (k < 2 ? 4 : 40);
+        if (m > len - start) m = len - start;
+        memcpy(needle, str + start, m);
+        needle[m] = '\0';
+        if (k == 3 && m > 0) needle[m - 1] ^= 1;
+        if (simd_count_occurrences(str, needle) != scalar_count_occurrences(str, needle)) {
+            fail("count_occurrences", str, len);
+        }
+    }
+}
+
+static void check_split(const char *str, size_t len, char delimiter, int max_tokens) {
+    static char a[BUF_SIZE], b[BUF_SIZE];
+    static char *ta[MAX_TOKENS], *tb[MAX_TOKENS];
+
+    memcpy(a, str, len + 1);
+    memcpy(b, str, len + 1);
+    int na = simd_split_string(a, delimiter, ta, max_tokens);
+    int nb = scalar_split_string(b, delimiter, tb, max_tokens);
+    bool same = na == nb && memcmp(a, b, len + 1) == 0;
+    for (int i = 0; same && i < na; i++) same = ta[i] - a == tb[i] - b;
+    if (!same) fail("split_string", str, len);
+}
+
+static void check_replace(const char *str, size_t len, char old_char, char new_char) {
+    static char a[BUF_SIZE], b[BUF_SIZE];
+
+    memcpy(a, str, len + 1);
+    memcpy(b, str, len + 1);
+    simd_string_replace(a, old_char, new_char);
+    scalar_string_replace(b, old_char, new_char);
+    if (memcmp(a, b, len + 1) != 0) fail("string_replace", str, len);
+}
+
+// 所有长度、所有对齐、所有字符集
+static void test_lengths_and_offsets(void) {
+    static char buf[BUF_SIZE + 64] __attribute__((aligned(64)));
+
+    for (size_t ai = 0; ai < sizeof(alphabets) / sizeof(alphabets[0]); ai++) {
+        for (size_t len = 0; len <= MAX_LEN; len++) {
+            for (size_t offset = 0; offset < 64; offset++) {
+                char *s = buf + offset;
+                memset(buf, 'Z', sizeof(buf));
+                if (offset % 2) fill(s, len, alphabets[ai]);
+                else fill_palindrome(s, len, alphabets[ai]);
+                check_string(s, len);
+                check_split(s, len, alphabets[ai] ? alphabets[ai][0] : ',', MAX_TOKENS);
+                check_split(s, len, alphabets[ai] ? alphabets[ai][0] : ',', (int)(offset % 4));
+                check_replace(s, len, s[len ? next_random() % len : 0], (char)next_random());
+            }
+        }
+    }
+}
+
+// 全部 (old_char, new_char) 组合和全部分隔符
+static void test_all_chars(void) {
+    char s[300];
+    for (int i = 0; i < 255; i++) s[i] = (char)(i + 1);
+    for (int i = 255; i < 290; i++) s[i] = (char)(1 + next_random() % 4);
+    s[290] = '\0';
+
+    for (int old_char = 0; old_char < 256; old_char++) {
+        for (int new_char = 0; new_char < 256; new_char++) {
+            check_replace(s + old_char % 7, 290 - old_char % 7, (char)old_char, (char)new_char);
+        }
+    }
+    char t[MAX_LEN + 1];
+    for (int delimiter = 0; delimiter < 256; delimiter++) {
+        for (int k = 0; k < 20; k++) {
+            size_t len = next_random() % MAX_LEN;
+            for (size_t i = 0; i < len; i++) {
+                t[i] = next_random() % 3 ? (char)delimiter : (char)(1 + next_random() % 255);
+                if (t[i] == '\0') t[i] = 'q';
+            }
+            t[len] = '\0';
+            check_split(t, len, (char)delimiter, MAX_TOKENS);
+        }
+    }
+    checks += 256 * 256 + 256 * 20;
+}
+
+// {a, b} 上长度不超过 6 的全部子串，在重复性很强的文本中计数
+static void test_all_needles(void) {
+    char hay[MAX_LEN + 1], needle[8];
+    for (int k = 0; k < 200; k++) {
+        size_t len = next_random() % MAX_LEN;
+        for (size_t i = 0; i < len; i++) hay[i] = next_random() % (k % 2 ? 2 : 8) ? 'a' : 'b';
+        hay[len] = '\0';
+        for (int m = 1; m <= 6; m++) {
+            for (int bits = 0; bits < (1 << m); bits++) {
+                for (int i = 0; i < m; i++) needle[i] = (bits >> i) & 1 ? 'b' : 'a';
+                needle[m] = '\0';
+                checks++;
+                if (simd_count_occurrences(hay, needle) != scalar_count_occurrences(hay, needle)) {
+                    fail("count_occurrences (a/b)", hay, len);
+                }
+            }
+        }
+    }
+}
+
+// 字符串的 '\0' 正好是可访问页的最后一个字节：越界读取会直接崩溃
+static void test_page_end(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (map == MAP_FAILED || mprotect(map + page, page, PROT_NONE) != 0) {
+        printf("无法设置保护页，跳过\n");
+        return;
+    }
+    char *page_end = map + page;
+    for (size_t ai = 0; ai < sizeof(alphabets) / sizeof(alphabets[0]); ai++) {
+        for (size_t len = 0; len <= MAX_LEN; len++) {
+            char *s = page_end - len - 1;
+            fill(s, len, alphabets[ai]);
+            check_string(s, len);
+            check_split(s, len, alphabets[ai] ? alphabets[ai][0] : ',', MAX_TOKENS);
+            check_replace(s, len, s[0], '_');
+            // 直接在页尾原地运行会修改字符串的函数
+            simd_string_replace(s, s[0], '_');
+            simd_string_reverse(s);
+            simd_trim(s);
+            simd_count_words(s);
+            char *tokens[MAX_TOKENS];
+            simd_split_string(s, '_', tokens, MAX_TOKENS);
+        }
+    }
+    munmap(map, 2 * page);
+}
+
+// 字符串从可访问页的第一个字节开始：第一块向前读取不能越过页的起点
+static void test_page_start(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    char *map = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (map == MAP_FAILED || mprotect(map, page, PROT_NONE) != 0) {
+        printf("无法设置保护页，跳过\n");
+        return;
+    }
+    char *s = map + page;
+    for (size_t ai = 0; ai < sizeof(alphabets) / sizeof(alphabets[0]); ai++) {
+        for (size_t len = 0; len <= MAX_LEN; len++) {
+            fill(s, len, alphabets[ai]);
+            check_string(s, len);
+        }
+    }
+    munmap(map, 2 * page);
+}
+
+// 长文本：匹配落在开头附近和随机位置
+static void test_long_text(void) {
+    static char buf[16384 + 64];
+    static const char *const needles[] = {"a", "b", "xy", "xyz", "xyzzy", "xzzzzzzzzzzzzzzzzzzzy", "ab", "aab", "ba"};
+    for (int k = 0; k < 40; k++) {
+        size_t off = next_random() % 64;
+        size_t len = 256 + next_random() % 16000;
+        char *str = buf + off;
+        for (size_t i = 0; i < len; i++) str[i] = next_random() % (k % 2 ? 2 : 16) ? 'a' : 'b';
+        str[len] = '\0';
+        for (size_t ni = 0; ni < sizeof(needles) / sizeof(needles[0]); ni++) {
+            size_t m = strlen(needles[ni]);
+            for (int j = 0; j < 8; j++) {
+                size_t at = next_random() % (j < 4 ? 192 : len);
+                if (at + m <= len) memcpy(str + at, needles[ni], m);
+            }
+            checks++;
+            if (simd_count_occurrences(str, needles[ni]) != scalar_count_occurrences(str, needles[ni])) {
+                fail("count_occurrences (long)", str, len);
+            }
+        }
+    }
+}
+
+int main(void) {
+    printf("SIMD 字符串函数差分测试\n");
+    printf("==========================================\n");
+
+    int best = simd_string_supported();
+    for (int level = SIMD_SSE2; level <= best; level++) {
+        simd_string_set_level(level);
+        long checks_before = checks, failures_before = failures;
+        test_lengths_and_offsets();
+        test_all_chars();
+        test_all_needles();
+        test_page_end();
+        test_page_start();
+        test_long_text();
+        printf("%-6s %ld 组输入, %ld 处不一致\n", simd_string_level_name(level),
+               checks - checks_before, failures - failures_before);
+    }
+    if (best == SIMD_SCALAR) printf("此平台只有标量版本，无需比较\n");
+
+    printf("==========================================\n");
+    printf(failures ? "测试失败！\n" : "全部一致！\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,612 @@
+/*
+ * 子字符串搜索引擎
+ * 替代 string_manipulation.c 中 count_occurrences / string_contains 反复调用 strstr 的做法：
+ *   - 单个子串：先预处理（needle_compile），之后可以在任意多个文本中重复搜索。
+ *     默认用 SIMD 按子串中最少见的字节筛选候选位置，再核对第二个罕见字节和末字节，
+ *     最后逐一比较；如果核对误报的开销平均每字节超过 Two-Way（重复性很强的文本），
+ *     自动改用 Two-Way 算法，保证最坏情况下也是线性时间。
+ *   - 多个子串：Aho-Corasick 自动机（ac_build），扫描一遍文本即可得到每个子串的次数。
+ * 计数都是不重叠的，与原 count_occurrences 的结果相同；空子串计为 0 次。
+ * 依赖 simd_string.h 的运行时指令集选择，同样只需 #include。
+ * C17/C18 标准
+ */
+
+#ifndef STR_SEARCH_H
+#define STR_SEARCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simd_string.h"
+
+// 预处理过的子串；只保存指针，needle 指向的内容在使用期间必须有效
+typedef struct {
+    const char *needle;
+    size_t len;
+    size_t rare1, rare2;        // 用于筛选的两个位置（最少见的字节）
+    size_t suffix;              // Two-Way：临界分解位置
+    size_t period;              // Two-Way：周期（非周期子串时为移动距离）
+    bool periodic;
+} str_needle;
+
+// 误报的核对开销累计超过 4096 且平均每个扫描过的字节超过 2 时，改用 Two-Way
+// （Two-Way 每个字节大约两三个周期）；每个候选另计分支预测失败等固定开销
+#define NEEDLE_FALLBACK_MIN 4096
+#define NEEDLE_FALLBACK_RATIO 2
+#define NEEDLE_CANDIDATE_COST 16
+
+// 字节在英文文本中出现频率的粗略估计，越大越常见
+static inline int needle_byte_score(unsigned char c) {
+    static const char letters[] = "etaoinsrhldcumfpgwybvkxjqz";
+    if (c == ' ') return 255;
+    if (c >= 'a' && c <= 'z') return 240 - 8 * (int)(strchr(letters, c) - letters);
+    if (c >= 'A' && c <= 'Z') return 60 - 2 * (int)(strchr(letters, c | 0x20) - letters);
+    if (c == '\n' || c == ',' || c == '.') return 100;
+    if (c >= '0' && c <= '9') return 50;
+    if (c >= 0x21 && c < 0x7F) return 20;
+    return 5;
+}
+
+// Two-Way 的临界分解：按两种字节顺序各求一次最大后缀，取较大的位置
+static inline size_t needle_max_suffix(const unsigned char *x, size_t m, bool reverse, size_t *period) {
+    size_t ms = SIZE_MAX, j = 0, k = 1, p = 1;
+    while (j + k < m) {
+        unsigned char a = x[j + k], b = x[ms + k];
+        if (reverse ? a > b : a < b) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            ms = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return ms;
+}
+
+static inline void needle_compile(str_needle *nd, const char *needle, size_t len) {
+    nd->needle = needle;
+    nd->len = len;
+    nd->rare1 = nd->rare2 = 0;
+    nd->suffix = 0;
+    nd->period = 1;
+    nd->periodic = false;
+    if (len == 0) return;
+
+    const unsigned char *x = (const unsigned char *)needle;
+    for (size_t i = 1; i < len; i++) {
+        if (needle_byte_score(x[i]) < needle_byte_score(x[nd->rare1])) nd->rare1 = i;
+    }
+    // 第二个位置尽量选不同的字节，这样两个条件同时成立的概率最低
+    int best = 1 << 30;
+    for (size_t i = 0; i < len; i++) {
+        if (i == nd->rare1) continue;
+        // 相邻字节高度相关（如 "zy"），隔开一些更能排除误报
+        int score = needle_byte_score(x[i]) + (x[i] == x[nd->rare1] ? 256 : 0) +
+                    (i + 1 == nd->rare1 || i == nd->rare1 + 1 ? 64 : 0);
+        if (score < best) {
+            best = score;
+            nd->rare2 = i;
+        }
+    }
+    if (len == 1) nd->rare2 = 0;
+
+    size_t p1, p2;
+    size_t s1 = needle_max_suffix(x, len, false, &p1);
+    size_t s2 = needle_max_suffix(x, len, true, &p2);
+    if (s1 + 1 >= s2 + 1) {
+        nd->suffix = s1 + 1;
+        nd->period = p1;
+    } else {
+        nd->suffix = s2 + 1;
+        nd->period = p2;
+    }
+    nd->periodic = memcmp(needle, needle + nd->period, nd->suffix) == 0;
+    if (!nd->periodic) {
+        size_t right = len - nd->suffix;
+        nd->period = (nd->suffix > right ? nd->suffix : right) + 1;
+    }
+}
+
+// Two-Way 查找（Crochemore-Perrin），O(n + m)，不需要额外内存
+static inline const char *needle_two_way(const str_needle *nd, const char *hay, size_t n) {
+    const unsigned char *x = (const unsigned char *)nd->needle;
+    const unsigned char *y = (const unsigned char *)hay;
+    const size_t m = nd->len, suffix = nd->suffix, period = nd->period;
+    if (m > n) return NULL;
+    size_t j = 0;
+    if (nd->periodic) {
+        size_t memory = 0;      // 上一次移动后已知匹配的前缀长度
+        while (j <= n - m) {
+            size_t i = suffix > memory ? suffix : memory;
+            while (i < m && x[i] == y[i + j]) i++;
+            if (i >= m) {
+                i = suffix - 1;
+                while (memory < i + 1 && x[i] == y[i + j]) i--;
+                if (i + 1 < memory + 1) return hay + j;
+                j += period;
+                memory = m - period;
+            } else {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    } else {
+        while (j <= n - m) {
+            size_t i = suffix;
+            while (i < m && x[i] == y[i + j]) i++;
+            if (i >= m) {
+                i = suffix - 1;
+                while (i != SIZE_MAX && x[i] == y[i + j]) i--;
+                if (i == SIZE_MAX) return hay + j;
+                j += period;
+            } else {
+                j += i - suffix + 1;
+            }
+        }
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// SIMD 筛选：a = hay + rare1（调用者让 a + j 按 32 字节对齐），b = hay + rare2，z = hay + len - 1。
+// 先只比较最少见的字节 c1，它不出现时每个起点只读一次文本；c1 出现的块再核对 c2 和末字节 cz，
+// 末字节离开头最远，周期性文本中前两个字节总在同一相位时也能排除误报。
+// c1 在文本中其实很常见时（超过四分之一的块出现 c1 却没有候选），第一步改为同时比较 c1 和 c2。
+// 从 j 起检查整块的起点，返回第一个有候选的 64 个起点，*mask 的第 k 位表示起点 j + k。
+// 只处理 j + 64 <= limit 的整块，返回值 + 64 > limit 表示没有更多整块。
+
+typedef struct {
+    const char *a, *b, *z;
+    char c1, c2, cz;
+    bool pair;                  // 第一步同时比较 c1 和 c2
+    size_t noise;               // c1 出现但没有候选的块数
+} needle_filter;
+
+// 记录一个 size 字节的块中 c1 出现却没有候选；j 是块的起点，即已经扫描过的起点数
+static inline void needle_note_noise(needle_filter *f, size_t j, size_t size) {
+    if (++f->noise > 16 && f->noise * size * 4 > j) f->pair = true;
+}
+
+#ifdef SIMD_STRING_X86
+
+static inline uint64_t needle_hits_sse2(const needle_filter *f, size_t j) {
+    const __m128i v1 = _mm_set1_epi8(f->c1), v2 = _mm_set1_epi8(f->c2), vz = _mm_set1_epi8(f->cz);
+    uint64_t m = 0;
+    for (int k = 0; k < 4; k++) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(f->a + j + 16 * k));
+        __m128i y = _mm_loadu_si128((const __m128i *)(const void *)(f->b + j + 16 * k));
+        __m128i z = _mm_loadu_si128((const __m128i *)(const void *)(f->z + j + 16 * k));
+        __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(x, v1), _mm_and_si128(_mm_cmpeq_epi8(y, v2), _mm_cmpeq_epi8(z, vz)));
+        m |= (uint64_t)(uint32_t)_mm_movemask_epi8(hit) << (16 * k);
+    }
+    return m;
+}
+
+// 每次检查 64 个起点，第一步按 f->pair 只比较 c1 或同时比较 c1 和 c2
+static inline size_t needle_scan_sse2(needle_filter *f, size_t j, size_t limit, uint64_t *mask) {
+    const __m128i v1 = _mm_set1_epi8(f->c1), v2 = _mm_set1_epi8(f->c2);
+    for (; j + 64 <= limit; j += 64) {
+        const char *a = f->a + j, *b = f->b + j;
+        __m128i h0, h1, h2, h3;
+        if (!f->pair) {
+            h0 = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)a), v1);
+            h1 = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 16)), v1);
+            h2 = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 32)), v1);
+            h3 = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 48)), v1);
+        } else {
+            h0 = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)a), v1),
+                               _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(const void *)b), v2));
+            h1 = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 16)), v1),
+                               _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(const void *)(b + 16)), v2));
+            h2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 32)), v1),
+                               _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(const void *)(b + 32)), v2));
+            h3 = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(const void *)(a + 48)), v1),
+                               _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(const void *)(b + 48)), v2));
+        }
+        if (!_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(h0, h1), _mm_or_si128(h2, h3)))) continue;
+        uint64_t m = needle_hits_sse2(f, j);
+        if (m) {
+            *mask = m;
+            return j;
+        }
+        needle_note_noise(f, j, 64);
+    }
+    return j;
+}
+
+static inline __attribute__((target("avx2"))) uint64_t needle_hits_avx2(const needle_filter *f, size_t j) {
+    const __m256i v1 = _mm256_set1_epi8(f->c1), v2 = _mm256_set1_epi8(f->c2), vz = _mm256_set1_epi8(f->cz);
+    __m256i h[2];
+    for (int k = 0; k < 2; k++) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(const void *)(f->a + j + 32 * k));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(const void *)(f->b + j + 32 * k));
+        __m256i z = _mm256_loadu_si256((const __m256i *)(const void *)(f->z + j + 32 * k));
+        h[k] = _mm256_and_si256(_mm256_cmpeq_epi8(x, v1),
+                                _mm256_and_si256(_mm256_cmpeq_epi8(y, v2), _mm256_cmpeq_epi8(z, vz)));
+    }
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(h[0]) | (uint64_t)(uint32_t)_mm256_movemask_epi8(h[1]) << 32;
+}
+
+// 第一步有 c1（或 c1 和 c2）的 128 个起点：h 是第一步的比较结果，补上其余字节的比较，
+// 按 64 个起点一块返回第一个有候选的块
+static inline __attribute__((target("avx2")))
+bool needle_block_avx2(needle_filter *f, size_t *j, const __m256i h[4], uint64_t *mask) {
+    const __m256i v2 = _mm256_set1_epi8(f->c2), vz = _mm256_set1_epi8(f->cz);
+    for (int half = 0; half < 2; half++) {
+        uint64_t m = 0;
+        for (int k = 0; k < 2; k++) {
+            size_t at = *j + 64 * half + 32 * k;
+            __m256i x = _mm256_and_si256(h[2 * half + k], _mm256_cmpeq_epi8(
+                _mm256_loadu_si256((const __m256i *)(const void *)(f->z + at)), vz));
+            if (!f->pair) {
+                x = _mm256_and_si256(x, _mm256_cmpeq_epi8(
+                    _mm256_loadu_si256((const __m256i *)(const void *)(f->b + at)), v2));
+            }
+            m |= (uint64_t)(uint32_t)_mm256_movemask_epi8(x) << (32 * k);
+        }
+        if (m) {
+            *mask = m;
+            *j += 64 * half;
+            return true;
+        }
+    }
+    needle_note_noise(f, *j, 128);
+    return false;
+}
+
+// 每次检查 128 个起点；两种第一步各用一个循环，c1 太常见时从第一个切换到第二个
+static inline __attribute__((target("avx2")))
+size_t needle_scan_avx2(needle_filter *f, size_t j, size_t limit, uint64_t *mask) {
+    const __m256i v1 = _mm256_set1_epi8(f->c1), v2 = _mm256_set1_epi8(f->c2);
+    for (; !f->pair && j + 128 <= limit; j += 128) {
+        const char *a = f->a + j;
+        __m256i h0 = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)a), v1);
+        __m256i h1 = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 32)), v1);
+        __m256i h2 = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 64)), v1);
+        __m256i h3 = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 96)), v1);
+        __m256i h = _mm256_or_si256(_mm256_or_si256(h0, h1), _mm256_or_si256(h2, h3));
+        if (!_mm256_testz_si256(h, h) && needle_block_avx2(f, &j, (const __m256i[4]){h0, h1, h2, h3}, mask)) {
+            return j;
+        }
+    }
+    for (; j + 128 <= limit; j += 128) {
+        const char *a = f->a + j, *b = f->b + j;
+        __m256i h0 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)a), v1),
+                                      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(const void *)b), v2));
+        __m256i h1 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 32)), v1),
+                                      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(const void *)(b + 32)), v2));
+        __m256i h2 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 64)), v1),
+                                      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(const void *)(b + 64)), v2));
+        __m256i h3 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(const void *)(a + 96)), v1),
+                                      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(const void *)(b + 96)), v2));
+        __m256i h = _mm256_or_si256(_mm256_or_si256(h0, h1), _mm256_or_si256(h2, h3));
+        if (!_mm256_testz_si256(h, h) && needle_block_avx2(f, &j, (const __m256i[4]){h0, h1, h2, h3}, mask)) {
+            return j;
+        }
+    }
+    // 最后一个 64 个起点的整块
+    if (j + 64 <= limit) {
+        uint64_t m = needle_hits_avx2(f, j);
+        if (m) {
+            *mask = m;
+            return j;
+        }
+        j += 64;
+    }
+    return j;
+}
+
+#endif // SIMD_STRING_X86
+
+static inline bool needle_filter_at(const needle_filter *f, size_t j) {
+    return f->a[j] == f->c1 && f->b[j] == f->c2 && f->z[j] == f->cz;
+}
+
+static inline size_t needle_scan_scalar(needle_filter *f, size_t j, size_t limit, uint64_t *mask) {
+    for (; j + 64 <= limit; j += 64) {
+        uint64_t m = 0;
+        for (int k = 0; k < 64; k++) {
+            m |= (uint64_t)needle_filter_at(f, j + k) << k;
+        }
+        if (m) {
+            *mask = m;
+            return j;
+        }
+    }
+    return j;
+}
+
+static inline size_t needle_scan(needle_filter *f, size_t j, size_t limit, uint64_t *mask) {
+#ifdef SIMD_STRING_X86
+    switch (simd_string_level()) {
+    case SIMD_AVX2: return needle_scan_avx2(f, j, limit, mask);
+    case SIMD_SSE2: return needle_scan_sse2(f, j, limit, mask);
+    default: break;
+    }
+#endif
+    return needle_scan_scalar(f, j, limit, mask);
+}
+
+// 候选与子串相同的前缀长度，等于 m 表示匹配
+static inline size_t needle_prefix(const char *s, const char *needle, size_t m) {
+    size_t i = 0;
+    while (i < m && s[i] == needle[i]) i++;
+    return i;
+}
+
+// 从 hay[0] 起依次找不重叠的匹配。find 为 true 时返回第一个匹配；
+// 否则把匹配次数累加到 *count 并返回 NULL
+static inline const char *needle_search(const str_needle *nd, const char *hay, size_t n,
+                                        bool find, size_t *count) {
+    const size_t m = nd->len;
+    if (m == 0 || m > n) return NULL;
+    const size_t limit = n - m + 1;     // 起点的个数
+    needle_filter f = {hay + nd->rare1, hay + nd->rare2, hay + m - 1,
+                       nd->needle[nd->rare1], nd->needle[nd->rare2], nd->needle[m - 1], false, 0};
+    size_t j = 0, next = 0;             // next：上一个匹配之后的位置
+    size_t cost = 0;                    // 误报的核对开销（比较的字节数加上每个候选的固定开销）
+    while (j < limit) {
+        uint64_t mask = 0;
+        size_t span = 64;               // 本块覆盖的起点数
+        size_t skew = (uintptr_t)(f.a + j) % 32;
+        if (skew == 0) {
+            j = needle_scan(&f, j, limit, &mask);
+        }
+        if (skew != 0 || j + 64 > limit) {
+            // 对齐之前的开头和不足 64 个起点的结尾：逐个检查
+            span = skew ? 32 - skew : 64;
+            if (span > limit - j) span = limit - j;
+            mask = 0;
+            for (size_t k = 0; k < span; k++) {
+                mask |= (uint64_t)needle_filter_at(&f, j + k) << k;
+            }
+        }
+        if (next > j) mask &= next - j >= 64 ? 0 : ~(uint64_t)0 << (next - j);
+        while (mask) {
+            size_t pos = j + __builtin_ctzll(mask);
+            mask &= mask - 1;
+            size_t same = needle_prefix(hay + pos, nd->needle, m);
+            if (same == m) {
+                if (find) return hay + pos;
+                ++*count;
+                next = pos + m;
+                mask &= next - j >= 64 ? 0 : ~(uint64_t)0 << (next - j);
+                continue;
+            }
+            cost += same + NEEDLE_CANDIDATE_COST;
+            if (cost > NEEDLE_FALLBACK_MIN && cost > pos * NEEDLE_FALLBACK_RATIO) {
+                // 平均每个字节的核对开销已经超过 Two-Way：剩下的部分交给它
+                j = pos + 1 > next ? pos + 1 : next;
+                while (j + m <= n) {
+                    const char *hit = needle_two_way(nd, hay + j, n - j);
+                    if (!hit || find) return hit;
+                    ++*count;
+                    j = (size_t)(hit - hay) + m;
+                }
+                return NULL;
+            }
+        }
+        j += span;
+    }
+    return NULL;
+}
+
+// 第一次出现的位置，没有则返回 NULL（与 memmem 相同，但空子串返回 NULL）
+static inline const char *needle_find(const str_needle *nd, const char *hay, size_t n) {
+    return needle_search(nd, hay, n, true, NULL);
+}
+
+// 不重叠出现的次数
+static inline size_t needle_count(const str_needle *nd, const char *hay, size_t n) {
+    size_t count = 0;
+    needle_search(nd, hay, n, false, &count);
+    return count;
+}
+
+// string_manipulation.c 中两个函数的替代版本（每次调用都重新预处理子串）
+static inline int search_count_occurrences(const char *str, const char *substr) {
+    // 单字节子串直接用 simd_string.h 的计数内核，不需要先求 strlen(str)
+    if (substr[0] != '\0' && substr[1] == '\0') return simd_count_occurrences(str, substr);
+    str_needle nd;
+    needle_compile(&nd, substr, strlen(substr));
+    return (int)needle_count(&nd, str, strlen(str));
+}
+
+static inline bool search_string_contains(const char *str, const char *substr) {
+    if (*substr == '\0') return true;   // 与 strstr 相同
+    str_needle nd;
+    needle_compile(&nd, substr, strlen(substr));
+    return needle_find(&nd, str, strlen(str)) != NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Aho-Corasick 多子串搜索
+// 转移表是完整的 DFA：状态数 x 字节类别数。只有出现在某个子串中的字节有自己的类别，
+// 其余字节共用类别 0，表的宽度因此只有几十列。
+// 表中存的是目标状态的行起点；最高位为 1 表示目标状态（或其失败链上）有子串结束。
+
+#define AC_OUTPUT 0x80000000u
+
+typedef struct {
+    uint32_t *next;         // states * classes
+    int32_t *first_out;     // 每个状态：在此结束的第一个子串，-1 表示没有
+    int32_t *out_next;      // 每个子串：在同一状态结束的下一个子串
+    int32_t *dict;          // 每个状态：失败链上最近的有子串结束的状态，-1 表示没有
+    size_t *lens;           // 每个子串的长度
+    int states, classes, count;
+    uint8_t cls[256];
+} ac_automaton;
+
+static inline void ac_free(ac_automaton *ac) {
+    free(ac->next);
+    free(ac->first_out);
+    free(ac->out_next);
+    free(ac->dict);
+    free(ac->lens);
+    memset(ac, 0, sizeof(*ac));
+}
+
+// 为 count 个以 '\0' 结尾的子串建立自动机；内存不足时返回 -1
+static inline int ac_build(ac_automaton *ac, const char *const *patterns, int count) {
+    memset(ac, 0, sizeof(*ac));
+    size_t total = 1;
+    bool used[256] = {false};
+    for (int p = 0; p < count; p++) {
+        for (const unsigned char *s = (const unsigned char *)patterns[p]; *s; s++) {
+            used[*s] = true;
+            total++;
+        }
+    }
+    ac->classes = 1;
+    for (int c = 0; c < 256; c++) {
+        ac->cls[c] = used[c] ? (uint8_t)ac->classes++ : 0;
+    }
+    const int classes = ac->classes;
+    if (total > (AC_OUTPUT - 1) / (size_t)classes) return -1;
+
+    int32_t *go = malloc(total * classes * sizeof(int32_t));
+    int32_t *fail = malloc(total * sizeof(int32_t));
+    int32_t *queue = malloc(total * sizeof(int32_t));
+    ac->first_out = malloc(total * sizeof(int32_t));
+    ac->dict = malloc(total * sizeof(int32_t));
+    ac->out_next = malloc((count ? count : 1) * sizeof(int32_t));
+    ac->lens = malloc((count ? count : 1) * sizeof(size_t));
+    if (!go || !fail || !queue || !ac->first_out || !ac->dict || !ac->out_next || !ac->lens) {
+        free(go);
+        free(fail);
+        free(queue);
+        ac_free(ac);
+        return -1;
+    }
+    ac->count = count;
+
+    // 1. 字典树（空子串不插入，计数为 0）
+    int states = 1;
+    memset(go, -1, (size_t)classes * sizeof(int32_t));
+    ac->first_out[0] = -1;
+    for (int p = 0; p < count; p++) {
+        int s = 0;
+        ac->lens[p] = strlen(patterns[p]);
+        ac->out_next[p] = -1;
+        if (ac->lens[p] == 0) continue;
+        for (const unsigned char *c = (const unsigned char *)patterns[p]; *c; c++) {
+            int32_t *slot = &go[(size_t)s * classes + ac->cls[*c]];
+            if (*slot < 0) {
+                memset(go + (size_t)states * classes, -1, (size_t)classes * sizeof(int32_t));
+                ac->first_out[states] = -1;
+                *slot = states++;
+            }
+            s = *slot;
+        }
+        ac->out_next[p] = ac->first_out[s];
+        ac->first_out[s] = p;
+    }
+    ac->states = states;
+
+    // 2. 按层次遍历求失败链接，同时把缺失的转移补成 DFA
+    int head = 0, tail = 0;
+    fail[0] = 0;
+    ac->dict[0] = -1;
+    for (int c = 0; c < classes; c++) {
+        int32_t t = go[c];
+        if (t < 0) {
+            go[c] = 0;
+        } else {
+            fail[t] = 0;
+            ac->dict[t] = -1;
+            queue[tail++] = t;
+        }
+    }
+    while (head < tail) {
+        int s = queue[head++];
+        for (int c = 0; c < classes; c++) {
+            int32_t *slot = &go[(size_t)s * classes + c];
+            int32_t f = go[(size_t)fail[s] * classes + c];
+            if (*slot < 0) {
+                *slot = f;
+            } else {
+                int t = *slot;
+                fail[t] = f;
+                ac->dict[t] = ac->first_out[f] >= 0 ? f : ac->dict[f];
+                queue[tail++] = t;
+            }
+        }
+    }
+
+    // 3. 转成行起点并标记输出
+    ac->next = malloc((size_t)states * classes * sizeof(uint32_t));
+    if (!ac->next) {
+        free(go);
+        free(fail);
+        free(queue);
+        ac_free(ac);
+        return -1;
+    }
+    for (size_t i = 0; i < (size_t)states * classes; i++) {
+        int t = go[i];
+        bool out = ac->first_out[t] >= 0 || ac->dict[t] >= 0;
+        ac->next[i] = (uint32_t)t * classes | (out ? AC_OUTPUT : 0);
+    }
+    free(go);
+    free(fail);
+    free(queue);
+    return 0;
+}
+
+// 扫描一遍 hay，counts[p] 为第 p 个子串不重叠出现的次数
+// （与对每个子串分别调用 count_occurrences 的结果相同）；返回总次数，内存不足时返回 SIZE_MAX
+static inline size_t ac_count_each(const ac_automaton *ac, const char *hay, size_t n, size_t *counts) {
+    size_t *last_end = calloc(ac->count ? ac->count : 1, sizeof(size_t));
+    if (!last_end) return SIZE_MAX;
+    memset(counts, 0, ac->count * sizeof(size_t));
+    size_t total = 0;
+    const uint32_t *next = ac->next;
+    const uint8_t *cls = ac->cls;
+    const unsigned char *y = (const unsigned char *)hay;
+    uint32_t row = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t t = next[row + cls[y[i]]];
+        row = t & ~AC_OUTPUT;
+        if (!(t & AC_OUTPUT)) continue;
+        // 依次报告在此状态及其失败链上结束的子串；同一子串的匹配按结束位置递增，
+        // 所以只要起点不早于上一次匹配的结束位置就计数，与反复调用 strstr 相同
+        for (int32_t s = (int32_t)(row / ac->classes); s >= 0; s = ac->dict[s]) {
+            for (int32_t p = ac->first_out[s]; p >= 0; p = ac->out_next[p]) {
+                size_t start = i + 1 - ac->lens[p];
+                if (start >= last_end[p]) {
+                    counts[p]++;
+                    total++;
+                    last_end[p] = i + 1;
+                }
+            }
+        }
+    }
+    free(last_end);
+    return total;
+}
+
+// 是否包含任一子串
+static inline bool ac_contains_any(const ac_automaton *ac, const char *hay, size_t n) {
+    const uint32_t *next = ac->next;
+    const unsigned char *y = (const unsigned char *)hay;
+    uint32_t row = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t t = next[row + ac->cls[y[i]]];
+        if (t & AC_OUTPUT) return true;
+        row = t;
+    }
+    return false;
+}
+
+#endif // STR_SEARCH_H
@@ -0,0 +1,318 @@
+/*
+ * str_search.h 的正确性检查与性能测试
+ * 1. 随机文本（小字符集，含周期性子串）上与逐位置比较的结果对照
+ * 2. 单个子串：自然文本与针对性构造的"对抗"文本，比较
+ *    strstr 循环（原 count_occurrences）、simd_count_occurrences、
+ *    只用 Two-Way、以及 needle_count（预处理后的子串）
+ * 3. 多个子串：每个子串分别计数 与 Aho-Corasick 扫描一遍
+ * 用法: ./str_search_bench [文本字节数]（至少 256）
+ * C17/C18 标准
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "str_search.h"
+
+static volatile size_t sink;
+
+static double now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned rng_state = 2024;
+
+static unsigned next_random(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+// 逐位置比较的参考实现（不重叠）
+static size_t naive_count(const char *hay, size_t n, const char *needle, size_t m) {
+    size_t count = 0;
+    if (m == 0) return 0;
+    for (size_t i = 0; i + m <= n; i++) {
+        if (memcmp(hay + i, needle, m) == 0) {
+            count++;
+            i += m - 1;
+        }
+    }
+    return count;
+}
+
+static size_t two_way_count(const str_needle *nd, const char *hay, size_t n) {
+    size_t count = 0, pos = 0;
+    const char *hit;
+    while (pos + nd->len <= n && (hit = needle_two_way(nd, hay + pos, n - pos)) != NULL) {
+        count++;
+        pos = (size_t)(hit - hay) + nd->len;
+    }
+    return count;
+}
+
+static const char *const words[] = {
+    "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "Hello",
+    "World", "string", "simd", "vector", "a", "benchmark", "of", "C17", "needle",
+    "haystack", "search", "engine", "pattern", "automaton", "period"
+};
+#define WORD_COUNT (sizeof(words) / sizeof(words[0]))
+
+static void natural_text(char *s, size_t n) {
+    size_t k = 0;
+    while (k < n) {
+        const char *w = words[next_random() % WORD_COUNT];
+        for (; *w && k < n; w++) s[k++] = *w;
+        if (k < n) s[k++] = next_random() % 9 ? ' ' : (next_random() % 2 ? ',' : '\n');
+    }
+    s[n] = '\0';
+}
+
+// ---------------------------------------------------------------------------
+
+static int check_correctness(void) {
+    static char hay[4097], needle[80];
+    int failures = 0, cases = 0;
+    int best = simd_string_supported();
+    for (int level = SIMD_SCALAR; level <= best; level++) {
+        simd_string_set_level(level);
+        for (int t = 0; t < 3000; t++) {
+            size_t n = next_random() % 4096;
+            int sigma = 1 + next_random() % 3;
+            for (size_t i = 0; i < n; i++) hay[i] = (char)('a' + next_random() % sigma);
+            hay[n] = '\0';
+            size_t m = 1 + next_random() % 70;
+            if (t % 3 == 0 && n > 0) {
+                // 子串取自文本本身
+                size_t start = next_random() % n;
+                if (m > n - start) m = n - start;
+                memcpy(needle, hay + start, m);
+            } else if (t % 3 == 1) {
+                // 周期性子串，最后一个字节可能不同
+                size_t period = 1 + next_random() % 4;
+                for (size_t i = 0; i < m; i++) needle[i] = (char)('a' + (i % period) % sigma);
+                if (next_random() % 2) needle[m - 1] = 'b';
+            } else {
+                for (size_t i = 0; i < m; i++) needle[i] = (char)('a' + next_random() % sigma);
+            }
+            needle[m] = '\0';
+
+            str_needle nd;
+            needle_compile(&nd, needle, m);
+            size_t expect = naive_count(hay, n, needle, m);
+            const char *first = needle_find(&nd, hay, n);
+            const char *first_expect = NULL;
+            for (size_t i = 0; !first_expect && i + m <= n; i++) {
+                if (memcmp(hay + i, needle, m) == 0) first_expect = hay + i;
+            }
+            cases++;
+            if (needle_count(&nd, hay, n) != expect || two_way_count(&nd, hay, n) != expect ||
+                first != first_expect ||
+                (size_t)search_count_occurrences(hay, needle) != expect ||
+                search_string_contains(hay, needle) != (first_expect != NULL)) {
+                if (++failures <= 5) printf("不一致: n=%zu 子串=\"%s\"\n", n, needle);
+            }
+        }
+
+        // Aho-Corasick：子串之间互为前缀/后缀，包括重复和空子串
+        for (int t = 0; t < 300; t++) {
+            char pool[40][12];
+            const char *patterns[40];
+            int count = 1 + next_random() % 40;
+            for (int p = 0; p < count; p++) {
+                size_t m = next_random() % 8;
+                for (size_t i = 0; i < m; i++) pool[p][i] = (char)('a' + next_random() % 3);
+                pool[p][m] = '\0';
+                patterns[p] = pool[p];
+            }
+            size_t n = next_random() % 2000;
+            for (size_t i = 0; i < n; i++) hay[i] = (char)('a' + next_random() % 3);
+            hay[n] = '\0';
+            ac_automaton ac;
+            size_t counts[40];
+            if (ac_build(&ac, patterns, count) != 0) return 1;
+            ac_count_each(&ac, hay, n, counts);
+            bool any = false;
+            cases++;
+            for (int p = 0; p < count; p++) {
+                size_t expect = naive_count(hay, n, patterns[p], strlen(patterns[p]));
+                any = any || expect > 0;
+                if (counts[p] != expect && ++failures <= 5) {
+                    printf("Aho-Corasick 不一致: 子串 \"%s\" %zu != %zu\n", patterns[p], counts[p], expect);
+                }
+            }
+            if (ac_contains_any(&ac, hay, n) != any && ++failures <= 5) printf("ac_contains_any 不一致\n");
+            ac_free(&ac);
+        }
+    }
+    simd_string_set_level(best);
+    printf("正确性检查: %d 组, %d 处不一致\n\n", cases, failures);
+    return failures;
+}
+
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char *name;
+    char *hay;
+    size_t n;
+    char needle[160];
+} bench_case;
+
+// 每种方法的最好成绩（GB/s），同时检查计数一致
+static void bench_single(const bench_case *bc) {
+    str_needle nd;
+    size_t m = strlen(bc->needle);
+    needle_compile(&nd, bc->needle, m);
+    double best[4] = {0, 0, 0, 0};
+    size_t counts[4] = {0, 0, 0, 0};
+    for (int trial = 0; trial < 5; trial++) {
+        for (int method = 0; method < 4; method++) {
+            double t = now();
+            size_t c = 0;
+            switch (method) {
+            case 0: c = (size_t)scalar_count_occurrences(bc->hay, bc->needle); break;
+            case 1: c = (size_t)simd_count_occurrences(bc->hay, bc->needle); break;
+            case 2: c = two_way_count(&nd, bc->hay, bc->n); break;
+            case 3: c = needle_count(&nd, bc->hay, bc->n); break;
+            }
+            t = now() - t;
+            counts[method] = c;
+            if (bc->n / t / 1e9 > best[method]) best[method] = bc->n / t / 1e9;
+        }
+    }
+    bool same = counts[0] == counts[1] && counts[1] == counts[2] && counts[2] == counts[3];
+    printf("%-28s %4zu %9zu %9.2f %9.2f %9.2f %9.2f%s\n", bc->name, m, counts[3],
+           best[0], best[1], best[2], best[3], same ? "" : "  计数不一致!");
+}
+
+static void bench_multi(char *hay, size_t n, int count) {
+    char (*pool)[16] = malloc(sizeof(*pool) * count);
+    const char **patterns = malloc(sizeof(*patterns) * count);
+    size_t *c1 = malloc(sizeof(size_t) * count), *c2 = malloc(sizeof(size_t) * count);
+    size_t *c3 = malloc(sizeof(size_t) * count);
+    str_needle *nds = malloc(sizeof(*nds) * count);
+    if (!pool || !patterns || !c1 || !c2 || !c3 || !nds) {
+        printf("内存不足\n");
+        free(pool);
+        free(patterns);
+        free(c1);
+        free(c2);
+        free(c3);
+        free(nds);
+        return;
+    }
+    // 一部分是文本中的单词，其余是随机的小写字母串（多半不出现）
+    for (int p = 0; p < count; p++) {
+        if (p < (int)WORD_COUNT) {
+            snprintf(pool[p], sizeof(pool[p]), "%s", words[p]);
+        } else {
+            size_t m = 3 + next_random() % 10;
+            for (size_t i = 0; i < m; i++) pool[p][i] = (char)('a' + next_random() % 26);
+            pool[p][m] = '\0';
+        }
+        patterns[p] = pool[p];
+    }
+
+    double t = now();
+    for (int p = 0; p < count; p++) c1[p] = (size_t)scalar_count_occurrences(hay, patterns[p]);
+    double t_strstr = now() - t;
+
+    t = now();
+    for (int p = 0; p < count; p++) {
+        needle_compile(&nds[p], patterns[p], strlen(patterns[p]));
+        c2[p] = needle_count(&nds[p], hay, n);
+    }
+    double t_needle = now() - t;
+
+    ac_automaton ac;
+    t = now();
+    if (ac_build(&ac, patterns, count) == 0) {
+        double t_build = now() - t;
+        t = now();
+        ac_count_each(&ac, hay, n, c3);
+        double t_ac = now() - t;
+
+        bool same = true;
+        for (int p = 0; p < count; p++) same = same && c1[p] == c2[p] && c2[p] == c3[p];
+        printf("%5d 个子串: strstr 循环 %8.1f ms, needle_count %8.1f ms, "
+               "Aho-Corasick %6.1f ms (建立 %.2f ms, %d 个状态 x %d 类)%s\n",
+               count, t_strstr * 1e3, t_needle * 1e3, t_ac * 1e3, t_build * 1e3,
+               ac.states, ac.classes, same ? "" : "  计数不一致!");
+        ac_free(&ac);
+    } else {
+        printf("内存不足\n");
+    }
+    free(pool);
+    free(patterns);
+    free(c1);
+    free(c2);
+    free(c3);
+    free(nds);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : (16u << 20);
+    if (n < 256) n = 256;   // 下面从文本中间截取 100 字节作为子串
+    int failures = check_correctness();
+
+    char *text = malloc(n + 1);
+    char *adv = malloc(n + 1);
+    if (!text || !adv) {
+        fprintf(stderr, "内存不足\n");
+        return 1;
+    }
+    natural_text(text, n);
+
+    printf("单个子串，%zu 字节文本 (GB/s)，级别 %s\n", n, simd_string_level_name(simd_string_level()));
+    printf("%-28s %4s %9s %9s %9s %9s %9s\n", "文本 / 子串", "长度", "次数",
+           "strstr", "simd_cnt", "two-way", "needle");
+
+    bench_case bc = {"自然文本 / benchmark", text, n, "benchmark"};
+    bench_single(&bc);
+    bc = (bench_case){"自然文本 / lazy dog", text, n, "lazy dog"};
+    bench_single(&bc);
+    bc = (bench_case){"自然文本 / xylophone (无)", text, n, "xylophone"};
+    bench_single(&bc);
+    bc = (bench_case){"自然文本 / 文本中的 100 字节", text, n, ""};
+    memcpy(bc.needle, text + n / 2, 100);
+    bc.needle[100] = '\0';
+    bench_single(&bc);
+
+    // a...a 中找 a...ab：每个位置都可能匹配，直到最后一个字节才失败
+    memset(adv, 'a', n);
+    adv[n] = '\0';
+    bc = (bench_case){"aaaa / a^31 b", adv, n, ""};
+    memset(bc.needle, 'a', 31);
+    strcpy(bc.needle + 31, "b");
+    bench_single(&bc);
+    bc = (bench_case){"aaaa / a^127 b", adv, n, ""};
+    memset(bc.needle, 'a', 127);
+    strcpy(bc.needle + 127, "b");
+    bench_single(&bc);
+    // (a^63 b)* 中找 a^64：两个筛选字节都是 a，候选全部是误报
+    for (size_t i = 0; i < n; i++) adv[i] = i % 64 == 63 ? 'b' : 'a';
+    bc = (bench_case){"(a^63 b)* / a^64", adv, n, ""};
+    memset(bc.needle, 'a', 64);
+    bc.needle[64] = '\0';
+    bench_single(&bc);
+    // (ab)* 中找 (ab)^32 b：周期性子串
+    for (size_t i = 0; i < n; i++) adv[i] = i % 2 ? 'b' : 'a';
+    bc = (bench_case){"(ab)* / (ab)^32 b", adv, n, ""};
+    for (int i = 0; i < 64; i++) bc.needle[i] = i % 2 ? 'b' : 'a';
+    strcpy(bc.needle + 64, "b");
+    bench_single(&bc);
+
+    size_t multi_n = n < (4u << 20) ? n : (4u << 20);
+    text[multi_n] = '\0';
+    printf("\n多个子串，%zu 字节自然文本\n", multi_n);
+    bench_multi(text, multi_n, 10);
+    bench_multi(text, multi_n, 100);
+    bench_multi(text, multi_n, 1000);
+
+    free(text);
+    free(adv);
+    return failures ? 1 : 0;
+}
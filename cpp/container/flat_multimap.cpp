@@ -0,0 +1,356 @@
+// flat_multimap.cpp
+// multimap.cpp 中成绩查询的扁平版本：键值对不再放在红黑树节点里，
+// 而是按 (键的哈希, 键编号, 插入顺序) 排好序后存进几个连续数组，
+// equal_range 先用哈希高位查一个小目录，再在哈希数组的一小段上做无分支二分查找。
+// 键在插入时驻留（intern）：相同的字符串只保存一份，条目里只存 32 位编号。
+// 用法是先批量 insert（不排序），再调用一次 sort()，之后才能查询；
+// sort() 之后还可以继续 insert，再 sort() 一次即可。
+// 同一个键的值保持插入顺序，与 std::multimap 相同。
+// g++ -std=c++17 -O2 flat_multimap.cpp -o flat_multimap
+// ./flat_multimap              # 演示 + 1K 到 1M 条的基准测试
+// ./flat_multimap 10000000     # 基准测试一直做到 10M 条
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 键驻留表：字符串 -> 编号，开放寻址，表中只存编号
+class StringPool {
+public:
+    static std::uint64_t hash(std::string_view s) {
+        return std::hash<std::string_view>()(s);
+    }
+
+    std::size_t size() const { return start_.size() - 1; }
+
+    std::string_view get(std::uint32_t id) const {
+        return std::string_view(text_.data() + start_[id], start_[id + 1] - start_[id]);
+    }
+
+    void reserve(std::size_t keys, std::size_t bytes) {
+        text_.reserve(bytes);
+        start_.reserve(keys + 1);
+        hashes_.reserve(keys);
+        if (keys * 4 > slots_.size() * 3)
+            rehash(keys * 4 / 3 + 1);
+    }
+
+    // 返回 s 的编号，第一次出现时分配新编号
+    std::uint32_t intern(std::string_view s, std::uint64_t h) {
+        if ((size() + 1) * 4 > slots_.size() * 3)
+            rehash(slots_.size() * 2);
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+            std::uint32_t id = slots_[i];
+            if (id == EMPTY) {
+                id = static_cast<std::uint32_t>(size());
+                text_.append(s.data(), s.size());
+                start_.push_back(static_cast<std::uint32_t>(text_.size()));
+                hashes_.push_back(h);
+                slots_[i] = id;
+                return id;
+            }
+            if (hashes_[id] == h && get(id) == s)
+                return id;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t EMPTY = 0xFFFFFFFFu;
+
+    void rehash(std::size_t want) {
+        std::size_t cap = 16;
+        while (cap < want)
+            cap *= 2;
+        slots_.assign(cap, EMPTY);
+        for (std::uint32_t id = 0; id < size(); ++id) {
+            std::size_t i = hashes_[id] & (cap - 1);
+            while (slots_[i] != EMPTY)
+                i = (i + 1) & (cap - 1);
+            slots_[i] = id;
+        }
+    }
+
+    std::string text_;                          // 所有键首尾相接
+    std::vector<std::uint32_t> start_{0};       // size() + 1 个偏移
+    std::vector<std::uint64_t> hashes_;
+    std::vector<std::uint32_t> slots_ = std::vector<std::uint32_t>(16, EMPTY);
+};
+
+template <typename V>
+class flat_multimap {
+public:
+    using mapped_type = V;
+    using range = std::pair<const V*, const V*>;
+
+    std::size_t size() const { return values_.size(); }
+    bool sorted() const { return sorted_ == values_.size(); }
+
+    void reserve(std::size_t entries, std::size_t keys, std::size_t keyBytes) {
+        hashes_.reserve(entries);
+        ids_.reserve(entries);
+        values_.reserve(entries);
+        pool_.reserve(keys, keyBytes);
+    }
+
+    // 追加一个键值对；查询之前必须调用 sort()
+    void insert(std::string_view key, const V& value) {
+        std::uint64_t h = StringPool::hash(key);
+        hashes_.push_back(h);
+        ids_.push_back(pool_.intern(key, h));
+        values_.push_back(value);
+    }
+
+    // 按 (哈希, 键编号, 插入顺序) 排序，三个数组一起重排
+    void sort() {
+        if (sorted())
+            return;
+        struct Rec {
+            std::uint64_t hash;
+            std::uint32_t id;
+            std::uint32_t pos;
+        };
+        std::vector<Rec> recs(size());
+        for (std::size_t i = 0; i < size(); ++i)
+            recs[i] = Rec{hashes_[i], ids_[i], static_cast<std::uint32_t>(i)};
+        auto less = [](const Rec& a, const Rec& b) {
+            if (a.hash != b.hash)
+                return a.hash < b.hash;
+            return a.id != b.id ? a.id < b.id : a.pos < b.pos;
+        };
+        // 已排好的前缀只需和新追加的部分归并
+        if (sorted_ > 0) {
+            std::sort(recs.begin() + sorted_, recs.end(), less);
+            std::inplace_merge(recs.begin(), recs.begin() + sorted_, recs.end(), less);
+        } else {
+            std::sort(recs.begin(), recs.end(), less);
+        }
+        std::vector<V> values;
+        values.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) {
+            hashes_[i] = recs[i].hash;
+            ids_[i] = recs[i].id;
+            values.push_back(std::move(values_[recs[i].pos]));
+        }
+        values_.swap(values);
+        sorted_ = size();
+        build_directory();
+    }
+
+    // 键为 key 的所有值，按插入顺序；未排序时抛出 std::logic_error
+    range equal_range(std::string_view key) const {
+        if (!sorted())
+            throw std::logic_error("flat_multimap: sort() before lookup");
+        const std::uint64_t h = StringPool::hash(key);
+        // 目录按哈希的高位把数组分成平均约 8 个条目的小段，二分只在段内进行
+        const std::size_t top = h >> shift_;
+        std::size_t lo = lower_bound(h, dir_[top], dir_[top + 1]);
+        std::size_t hi = lower_bound(h + 1, lo, dir_[top + 1]);
+        if (h == UINT64_MAX)
+            hi = size();
+        const V* none = values_.data();
+        if (lo == hi)
+            return range(none, none);
+        // 哈希相同的一段里，每个键又是连续的一小段；几乎总是只有一个键
+        while (lo < hi && pool_.get(ids_[lo]) != key) {
+            std::uint32_t skip = ids_[lo];
+            while (lo < hi && ids_[lo] == skip)
+                ++lo;
+        }
+        if (lo == hi)
+            return range(none, none);
+        std::size_t end = lo + 1;
+        if (ids_[hi - 1] == ids_[lo])
+            end = hi;
+        else
+            while (end < hi && ids_[end] == ids_[lo])
+                ++end;
+        return range(values_.data() + lo, values_.data() + end);
+    }
+
+    std::size_t count(std::string_view key) const {
+        range r = equal_range(key);
+        return r.second - r.first;
+    }
+
+    // 第 i 个条目（排序后的顺序）
+    std::string_view key_at(std::size_t i) const { return pool_.get(ids_[i]); }
+    const V& value_at(std::size_t i) const { return values_[i]; }
+
+private:
+    // [first, last) 中第一个哈希 >= h 的位置；循环里只有条件传送
+    std::size_t lower_bound(std::uint64_t h, std::size_t first, std::size_t last) const {
+        const std::uint64_t* base = hashes_.data() + first;
+        std::size_t n = last - first;
+        if (n == 0)
+            return first;
+        while (n > 1) {
+            std::size_t half = n / 2;
+            base = base[half] < h ? base + half : base;
+            n -= half;
+        }
+        return (base - hashes_.data()) + (*base < h);
+    }
+
+    // dir_[k] 是第一个哈希高位 >= k 的条目，共 2^bits + 1 项
+    void build_directory() {
+        int bits = 1;
+        while (bits < 32 && (std::size_t(8) << bits) < size())
+            ++bits;
+        shift_ = 64 - bits;
+        dir_.assign((std::size_t(1) << bits) + 1, 0);
+        std::size_t i = 0;
+        for (std::size_t k = 0; k + 1 < dir_.size(); ++k) {
+            dir_[k] = i;
+            while (i < size() && (hashes_[i] >> shift_) == k)
+                ++i;
+        }
+        dir_.back() = size();
+    }
+
+    std::vector<std::uint64_t> hashes_;
+    std::vector<std::uint32_t> ids_;
+    std::vector<V> values_;
+    StringPool pool_;
+    std::size_t sorted_ = 0;         // 前 sorted_ 个条目有序
+    std::vector<std::size_t> dir_ = std::vector<std::size_t>(3, 0);
+    int shift_ = 63;
+};
+
+// 与 multimap.cpp 相同的三个场景
+void demo() {
+    flat_multimap<int> scores;
+    scores.insert("Alice", 90);
+    scores.insert("Bob", 85);
+    scores.insert("Alice", 95);
+    scores.insert("Bob", 78);
+    scores.insert("Alice", 88);
+    scores.sort();
+
+    std::cout << "--- Alice 的所有成绩 ---\n";
+    auto alice = scores.equal_range("Alice");
+    for (const int* p = alice.first; p != alice.second; ++p)
+        std::cout << "Alice: " << *p << "\n";
+
+    std::cout << "\n--- 查找不存在的键 ---\n";
+    const std::string key = "Charlie";
+    if (scores.count(key) == 0)
+        std::cout << "键 '" << key << "' 不存在\n";
+
+    std::cout << "\n--- 使用 equal_range 查找 Bob ---\n";
+    auto bob = scores.equal_range("Bob");
+    for (const int* p = bob.first; p != bob.second; ++p)
+        std::cout << "Bob: " << *p << "\n";
+
+    std::cout << "\n--- 排序后再插入 ---\n";
+    scores.insert("Charlie", 70);
+    scores.insert("Alice", 60);
+    scores.sort();
+    std::cout << "Alice 有 " << scores.count("Alice") << " 个成绩, Charlie 有 "
+              << scores.count(key) << " 个\n";
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+}
+
+// n 个条目，平均每个键 4 个成绩；查询随机的已有键和 1/8 不存在的键
+bool bench(std::size_t n) {
+    const std::size_t keys = std::max<std::size_t>(1, n / 4);
+    std::mt19937_64 rng(n);
+    std::vector<std::string> names(keys);
+    for (std::size_t k = 0; k < keys; ++k)
+        names[k] = "student" + std::to_string(rng());
+    std::vector<std::pair<const std::string*, int>> input(n);
+    for (auto& e : input)
+        e = {&names[rng() % keys], static_cast<int>(rng() % 101)};
+    const std::size_t queries = std::min<std::size_t>(std::max<std::size_t>(n, 100000), 1000000);
+    std::vector<std::string> probes(queries);
+    for (auto& q : probes)
+        q = rng() % 8 ? names[rng() % keys] : "nobody" + std::to_string(rng());
+
+    using clock = std::chrono::steady_clock;
+    auto t = clock::now();
+    std::multimap<std::string, int> tree;
+    for (const auto& e : input)
+        tree.insert({*e.first, e.second});
+    double treeBuild = seconds_since(t);
+
+    t = clock::now();
+    std::unordered_multimap<std::string, int> hashed;
+    for (const auto& e : input)
+        hashed.insert({*e.first, e.second});
+    double hashBuild = seconds_since(t);
+
+    t = clock::now();
+    flat_multimap<int> flat;
+    flat.reserve(n, keys, keys * 26);
+    for (const auto& e : input)
+        flat.insert(*e.first, e.second);
+    flat.sort();
+    double flatBuild = seconds_since(t);
+
+    // 每次查询把所有值按位置加权求和，顺序不同也会被发现
+    long long treeSum = 0, hashSum = 0, flatSum = 0;
+    t = clock::now();
+    for (const auto& q : probes) {
+        auto r = tree.equal_range(q);
+        long long w = 1;
+        for (auto it = r.first; it != r.second; ++it)
+            treeSum += it->second * w++;
+    }
+    double treeFind = seconds_since(t);
+
+    t = clock::now();
+    for (const auto& q : probes) {
+        auto r = hashed.equal_range(q);
+        for (auto it = r.first; it != r.second; ++it)
+            hashSum += it->second;
+    }
+    double hashFind = seconds_since(t);
+
+    t = clock::now();
+    long long flatPlain = 0;
+    for (const auto& q : probes) {
+        auto r = flat.equal_range(q);
+        long long w = 1;
+        for (const int* p = r.first; p != r.second; ++p) {
+            flatSum += *p * w++;
+            flatPlain += *p;
+        }
+    }
+    double flatFind = seconds_since(t);
+
+    auto mops = [queries](double s) { return queries / s / 1e6; };
+    std::cout << n << " 条:\n"
+              << "  构建  multimap " << treeBuild * 1e3 << " ms, unordered_multimap "
+              << hashBuild * 1e3 << " ms, flat " << flatBuild * 1e3 << " ms\n"
+              << "  查询  multimap " << mops(treeFind) << " M/s, unordered_multimap "
+              << mops(hashFind) << " M/s, flat " << mops(flatFind) << " M/s ("
+              << treeFind / flatFind << "x multimap)\n";
+    bool same = treeSum == flatSum && hashSum == flatPlain && flat.size() == tree.size();
+    if (!same)
+        std::cout << "  结果不一致!\n";
+    return same;
+}
+
+int main(int argc, char* argv[]) {
+    demo();
+
+    const std::size_t largest = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::cout << "\n=== 基准测试 ===\n";
+    bool ok = true;
+    for (std::size_t n = 1000; n <= largest; n *= 10)
+        ok = bench(n) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// randwalkb.cpp -- many random walkers at once with VectorBatch
+// compile with vect.cpp vectbatch.cpp
+// g++ -std=c++11 -O2 -fopenmp-simd -fno-math-errno randwalkb.cpp vect.cpp vectbatch.cpp -o randwalkb
+// usage: randwalkb [target] [step] [walkers]
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "vect.h"
+#include "vectbatch.h"
+
+// scalar walk exactly as randwalk.cpp does it
+unsigned long scalar_walk(double target, double dstep)
+{
+    using VECTOR::Vector;
+    Vector step;
+    Vector result(0.0, 0.0);
+    unsigned long steps = 0;
+    while (result.magval() < target)
+    {
+        double direction = std::rand() % 360;
+        step.reset(dstep, direction, Vector::POL);
+        result = result + step;
+        steps++;
+    }
+    return steps;
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace std;
+    using VECTOR::VectorBatch;
+    double target = argc > 1 ? atof(argv[1]) : 50.0;
+    double dstep = argc > 2 ? atof(argv[2]) : 2.0;
+    size_t walkers = argc > 3 ? strtoul(argv[3], 0, 10) : 4096;
+
+    // directions are whole degrees, as rand() % 360 in randwalk.cpp,
+    // so the trigonometry is done once up front; this table, not the
+    // vectorized += and mag2, is where most of the speedup over Vector comes from
+    const double Rad_per_deg = atan(1.0) / 45.0;
+    double unit_x[360], unit_y[360];
+    for (int d = 0; d < 360; d++)
+    {
+        unit_x[d] = dstep * cos(d * Rad_per_deg);
+        unit_y[d] = dstep * sin(d * Rad_per_deg);
+    }
+
+    VectorBatch pos(walkers), step(walkers);
+    vector<uint64_t> rng(walkers);
+    vector<unsigned long> count(walkers, 0);
+    vector<double> m2(walkers);
+    for (size_t i = 0; i < walkers; i++)
+        rng[i] = 0x9E3779B97F4A7C15ULL * (i + 1);
+
+    const double target2 = target * target;
+    unsigned long total_steps = 0;
+    double sum_out = 0.0;       // sum of final distance / steps
+    size_t done = 0;
+    auto start = chrono::steady_clock::now();
+    while (pos.size() > 0)
+    {
+        const size_t n = pos.size();
+        double * sx = step.x();
+        double * sy = step.y();
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t r = rng[i];            // xorshift64 per walker
+            r ^= r << 13;
+            r ^= r >> 7;
+            r ^= r << 17;
+            rng[i] = r;
+            unsigned d = static_cast<unsigned>(((r >> 32) * 360) >> 32);
+            sx[i] = unit_x[d];
+            sy[i] = unit_y[d];
+            count[i]++;
+        }
+        pos += step;
+        pos.mag2(m2.data());
+        // retire walkers that reached the target by swapping in the last one
+        for (size_t i = n; i-- > 0; )
+        {
+            if (m2[i] < target2)
+                continue;
+            total_steps += count[i];
+            sum_out += sqrt(m2[i]) / count[i];
+            done++;
+            size_t last = pos.size() - 1;
+            pos.swap_elements(i, last);
+            swap(rng[i], rng[last]);
+            swap(count[i], count[last]);
+            swap(m2[i], m2[last]);
+            pos.pop_back();
+            step.pop_back();
+        }
+    }
+    chrono::duration<double> batch_time = chrono::steady_clock::now() - start;
+
+    srand(1);
+    unsigned long scalar_steps = 0;
+    start = chrono::steady_clock::now();
+    for (size_t w = 0; w < walkers; w++)
+        scalar_steps += scalar_walk(target, dstep);
+    chrono::duration<double> scalar_time = chrono::steady_clock::now() - start;
+
+    cout << walkers << " walkers, target " << target << ", step " << dstep << "\n";
+    cout << "VectorBatch: " << double(total_steps) / done << " steps per walk, "
+         << "average outward distance per step " << sum_out / done << ", "
+         << total_steps / batch_time.count() / 1e6 << " M steps/s\n";
+    cout << "Vector:      " << double(scalar_steps) / walkers << " steps per walk, "
+         << scalar_steps / scalar_time.count() / 1e6 << " M steps/s\n";
+    return 0;
+}
@@ -0,0 +1,75 @@
+// vectbatch.cpp -- methods for the VectorBatch class
+// The element-wise loops are marked "omp simd" and only vectorize when built
+// with -fopenmp-simd; the sqrt loop also needs -fno-math-errno, otherwise the
+// errno check keeps it scalar. The atan2 loop is left scalar.
+#include <cmath>
+#include <utility>
+#include "vectbatch.h"
+
+namespace VECTOR
+{
+    const double Rad_to_deg_batch = 45.0 / std::atan(1.0);
+
+    void VectorBatch::swap_elements(std::size_t i, std::size_t j)
+    {
+        std::swap(xs[i], xs[j]);
+        std::swap(ys[i], ys[j]);
+    }
+
+    VectorBatch & VectorBatch::operator+=(const VectorBatch & b)
+    {
+        double * __restrict px = xs.data();
+        double * __restrict py = ys.data();
+        const double * __restrict bx = b.xs.data();
+        const double * __restrict by = b.ys.data();
+        const std::size_t n = size();
+        #pragma omp simd
+        for (std::size_t i = 0; i < n; i++)
+        {
+            px[i] += bx[i];
+            py[i] += by[i];
+        }
+        return *this;
+    }
+
+    VectorBatch & VectorBatch::operator*=(double n)
+    {
+        double * __restrict px = xs.data();
+        double * __restrict py = ys.data();
+        const std::size_t count = size();
+        #pragma omp simd
+        for (std::size_t i = 0; i < count; i++)
+        {
+            px[i] *= n;
+            py[i] *= n;
+        }
+        return *this;
+    }
+
+    void VectorBatch::mag2(double * __restrict out) const
+    {
+        const double * __restrict px = xs.data();
+        const double * __restrict py = ys.data();
+        const std::size_t n = size();
+        #pragma omp simd
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = px[i] * px[i] + py[i] * py[i];
+    }
+
+    void VectorBatch::magnitudes(double * __restrict out) const
+    {
+        mag2(out);
+        const std::size_t n = size();
+        #pragma omp simd
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = std::sqrt(out[i]);
+    }
+
+    void VectorBatch::angles(double * __restrict out) const
+    {
+        const std::size_t n = size();
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = (xs[i] == 0.0 && ys[i] == 0.0)
+                   ? 0.0 : std::atan2(ys[i], xs[i]) * Rad_to_deg_batch;
+    }
+}   // end namespace VECTOR
@@ -0,0 +1,39 @@
+// vectbatch.h -- structure-of-arrays batch of 2-D vectors
+// Only rectangular coordinates are stored, one array per component, so the
+// element-wise kernels are simple loops over contiguous arrays (see
+// vectbatch.cpp for the flags that vectorize them). Magnitude and angle are
+// computed on request instead of being kept up to date.
+#ifndef VECTBATCH_H_
+#define VECTBATCH_H_
+#include <cstddef>
+#include <vector>
+#include "vect.h"
+
+namespace VECTOR
+{
+    class VectorBatch
+    {
+    private:
+        std::vector<double> xs;     // x components
+        std::vector<double> ys;     // y components
+    public:
+        explicit VectorBatch(std::size_t n = 0) : xs(n, 0.0), ys(n, 0.0) { }
+        std::size_t size() const { return xs.size(); }
+        void resize(std::size_t n) { xs.resize(n, 0.0); ys.resize(n, 0.0); }
+        double * x() { return xs.data(); }
+        double * y() { return ys.data(); }
+        const double * x() const { return xs.data(); }
+        const double * y() const { return ys.data(); }
+        void set(std::size_t i, const Vector & v) { xs[i] = v.xval(); ys[i] = v.yval(); }
+        Vector get(std::size_t i) const { return Vector(xs[i], ys[i]); }
+        void swap_elements(std::size_t i, std::size_t j);
+        void pop_back() { xs.pop_back(); ys.pop_back(); }
+    // element-wise kernels; batches must be the same size
+        VectorBatch & operator+=(const VectorBatch & b);
+        VectorBatch & operator*=(double n);
+        void mag2(double * out) const;          // squared magnitudes
+        void magnitudes(double * out) const;
+        void angles(double * out) const;        // degrees, as Vector::angval() * Rad_to_deg
+    };
+}   // end namespace VECTOR
+#endif
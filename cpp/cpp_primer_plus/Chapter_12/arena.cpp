@@ -0,0 +1,258 @@
+// arena.cpp -- BumpArena, PoolResource and ThreadCache methods
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include "arena.h"
+
+namespace ARENA
+{
+    namespace
+    {
+        const std::size_t CHUNK_ALIGN = alignof(std::max_align_t);
+
+        char * align_up(char * p, std::size_t align)
+        {
+            std::uintptr_t u = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((align - u % align) % align);
+        }
+    }
+
+    // BumpArena methods
+
+    BumpArena::BumpArena(void * buf, std::size_t size, std::pmr::memory_resource * up)
+        : initial(static_cast<char *>(buf)), initialSize(size),
+          cur(initial), end(initial + size), chunks(nullptr),
+          firstSize(std::max<std::size_t>(size, 1024)), nextSize(firstSize),
+          upstream(up)
+    {
+    }
+
+    BumpArena::BumpArena(std::size_t firstChunk, std::pmr::memory_resource * up)
+        : initial(nullptr), initialSize(0), cur(nullptr), end(nullptr),
+          chunks(nullptr), firstSize(std::max<std::size_t>(firstChunk, 64)),
+          nextSize(firstSize), upstream(up)
+    {
+    }
+
+    void * BumpArena::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        // aligning can step past end when fewer than align-1 bytes are left
+        char * p = cur ? align_up(cur, align) : nullptr;
+        if (!p || p > end || bytes > std::size_t(end - p))
+        {
+            // new chunk, at least twice the last and big enough for this request
+            std::size_t need = sizeof(Chunk) + bytes + align;
+            std::size_t size = std::max(nextSize, need);
+            Chunk * c = static_cast<Chunk *>(upstream->allocate(size, CHUNK_ALIGN));
+            c->next = chunks;
+            c->size = size;
+            chunks = c;
+            nextSize = size * 2;
+            cur = reinterpret_cast<char *>(c + 1);
+            end = reinterpret_cast<char *>(c) + size;
+            p = align_up(cur, align);
+        }
+        cur = p + bytes;
+        return p;
+    }
+
+    void BumpArena::release()
+    {
+        while (chunks)
+        {
+            Chunk * next = chunks->next;
+            upstream->deallocate(chunks, chunks->size, CHUNK_ALIGN);
+            chunks = next;
+        }
+        cur = initial;
+        end = initial + initialSize;
+        nextSize = firstSize;
+    }
+
+    std::size_t BumpArena::used() const
+    {
+        if (!cur)
+            return 0;
+        return chunks ? cur - reinterpret_cast<char *>(chunks + 1) : cur - initial;
+    }
+
+    // PoolResource methods
+
+    int PoolResource::size_class(std::size_t bytes, std::size_t align)
+    {
+        // blocks are multiples of STEP inside chunks aligned to CHUNK_ALIGN,
+        // so each is aligned to STEP
+        if (align > STEP || bytes > class_size(CLASSES - 1))
+            return -1;
+        return bytes == 0 ? 0 : int((bytes - 1) / STEP);
+    }
+
+    PoolResource::PoolResource(bool synchronized, std::pmr::memory_resource * up)
+        : chunkSize(16384), upstream(up), sync(synchronized)
+    {
+        std::fill(freeList, freeList + CLASSES, nullptr);
+    }
+
+    void PoolResource::release()
+    {
+        for (std::size_t i = 0; i < chunks.size(); i++)
+            upstream->deallocate(chunks[i].first, chunks[i].second, CHUNK_ALIGN);
+        chunks.clear();
+        std::fill(freeList, freeList + CLASSES, nullptr);
+    }
+
+    // carve a fresh chunk into blocks of class c
+    void PoolResource::refill(int c)
+    {
+        const std::size_t size = class_size(c);
+        const std::size_t bytes = std::max(chunkSize, 16 * size);
+        char * p = static_cast<char *>(upstream->allocate(bytes, CHUNK_ALIGN));
+        chunks.push_back(std::make_pair(static_cast<void *>(p), bytes));
+        if (chunkSize < (std::size_t(1) << 20))
+            chunkSize *= 2;
+        Block * head = freeList[c];
+        for (std::size_t off = bytes - bytes % size; off != 0; off -= size)
+        {
+            Block * b = reinterpret_cast<Block *>(p + off - size);
+            b->next = head;
+            head = b;
+        }
+        freeList[c] = head;
+    }
+
+    PoolResource::Block * PoolResource::take(int c, int n)
+    {
+        std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+        if (sync)
+            guard.lock();
+        Block * first = nullptr;
+        Block ** tail = &first;
+        for (int i = 0; i < n; i++)
+        {
+            if (!freeList[c])
+                refill(c);
+            Block * b = freeList[c];
+            freeList[c] = b->next;
+            *tail = b;
+            tail = &b->next;
+        }
+        *tail = nullptr;
+        return first;
+    }
+
+    void PoolResource::give(int c, Block * first, Block * last)
+    {
+        std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+        if (sync)
+            guard.lock();
+        last->next = freeList[c];
+        freeList[c] = first;
+    }
+
+    void * PoolResource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        int c = size_class(bytes, align);
+        if (c < 0)
+            return upstream->allocate(bytes, align);
+        return take(c, 1);
+    }
+
+    void PoolResource::do_deallocate(void * p, std::size_t bytes, std::size_t align)
+    {
+        int c = size_class(bytes, align);
+        if (c < 0)
+            upstream->deallocate(p, bytes, align);
+        else
+        {
+            Block * b = static_cast<Block *>(p);
+            give(c, b, b);
+        }
+    }
+
+    bool PoolResource::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+    {
+        if (this == &other)
+            return true;
+        const ThreadCache * tc = dynamic_cast<const ThreadCache *>(&other);
+        return tc && &tc->pool() == this;
+    }
+
+    // ThreadCache methods
+
+    ThreadCache::ThreadCache(PoolResource & pool) : shared(pool)
+    {
+        for (int c = 0; c < PoolResource::CLASSES; c++)
+        {
+            bins[c].head = nullptr;
+            bins[c].count = 0;
+        }
+    }
+
+    ThreadCache::~ThreadCache()
+    {
+        for (int c = 0; c < PoolResource::CLASSES; c++)
+        {
+            PoolResource::Block * first = bins[c].head;
+            if (!first)
+                continue;
+            PoolResource::Block * last = first;
+            while (last->next)
+                last = last->next;
+            shared.give(c, first, last);
+        }
+    }
+
+    void * ThreadCache::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        int c = PoolResource::size_class(bytes, align);
+        if (c < 0)
+            return shared.upstream_resource()->allocate(bytes, align);
+        Bin & bin = bins[c];
+        if (!bin.head)
+        {
+            bin.head = shared.take(c, BATCH);
+            bin.count = BATCH;
+        }
+        PoolResource::Block * b = bin.head;
+        bin.head = b->next;
+        bin.count--;
+        return b;
+    }
+
+    void ThreadCache::do_deallocate(void * p, std::size_t bytes, std::size_t align)
+    {
+        int c = PoolResource::size_class(bytes, align);
+        if (c < 0)
+        {
+            shared.upstream_resource()->deallocate(p, bytes, align);
+            return;
+        }
+        Bin & bin = bins[c];
+        PoolResource::Block * b = static_cast<PoolResource::Block *>(p);
+        b->next = bin.head;
+        bin.head = b;
+        // past 2 * BATCH blocks, keep the BATCH freed last and hand the rest
+        // back under a single lock
+        if (++bin.count > 2 * BATCH)
+        {
+            PoolResource::Block * last = bin.head;
+            for (int i = 1; i < BATCH; i++)
+                last = last->next;
+            PoolResource::Block * rest = last->next;
+            PoolResource::Block * tail = rest;
+            while (tail->next)
+                tail = tail->next;
+            last->next = nullptr;
+            shared.give(c, rest, tail);
+            bin.count = BATCH;
+        }
+    }
+
+    bool ThreadCache::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+    {
+        if (&other == &shared)
+            return true;
+        const ThreadCache * tc = dynamic_cast<const ThreadCache *>(&other);
+        return tc && &tc->shared == &shared;
+    }
+}   // end namespace ARENA
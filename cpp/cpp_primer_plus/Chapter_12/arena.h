@@ -0,0 +1,105 @@
+// arena.h -- memory resources for the pmr containers (C++17)
+// placenew1.cpp and placenew2.cpp carve objects out of a char buffer by
+// hand. These classes do the bookkeeping instead and plug into any
+// std::pmr container:
+//   BumpArena    hands out a buffer front to back; deallocate() is a no-op
+//                and everything is freed at once by release()
+//   PoolResource keeps one free list per size class (16-byte steps)
+//   ThreadCache  gives each thread its own free lists in front of a shared,
+//                synchronized PoolResource
+#ifndef ARENA_H_
+#define ARENA_H_
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace ARENA
+{
+    class BumpArena : public std::pmr::memory_resource
+    {
+    private:
+        struct Chunk { Chunk * next; std::size_t size; };
+        char * initial;             // caller's buffer, may be null
+        std::size_t initialSize;
+        char * cur;                 // next free byte
+        char * end;
+        Chunk * chunks;             // taken from upstream, newest first
+        std::size_t firstSize;      // size of the first chunk
+        std::size_t nextSize;       // size of the next chunk
+        std::pmr::memory_resource * upstream;
+
+        void * do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void *, std::size_t, std::size_t) override { }
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+            { return this == &other; }
+    public:
+        // use buf first, as placenew1.cpp uses its buffer, then the upstream
+        BumpArena(void * buf, std::size_t size,
+                  std::pmr::memory_resource * up = std::pmr::get_default_resource());
+        explicit BumpArena(std::size_t firstChunk = 4096,
+                  std::pmr::memory_resource * up = std::pmr::get_default_resource());
+        BumpArena(const BumpArena &) = delete;
+        BumpArena & operator=(const BumpArena &) = delete;
+        ~BumpArena() { release(); }
+        void release();             // objects must already be destroyed
+        std::size_t used() const;   // bytes handed out from the current block
+    };
+
+    class PoolResource : public std::pmr::memory_resource
+    {
+    public:
+        enum { STEP = 16, CLASSES = 64 };       // blocks of 16 .. 1024 bytes
+        struct Block { Block * next; };
+        // size class for a request, or -1 if it goes straight upstream
+        static int size_class(std::size_t bytes, std::size_t align);
+        static std::size_t class_size(int c) { return std::size_t(STEP) * (c + 1); }
+
+        explicit PoolResource(bool synchronized = false,
+                  std::pmr::memory_resource * up = std::pmr::get_default_resource());
+        PoolResource(const PoolResource &) = delete;
+        PoolResource & operator=(const PoolResource &) = delete;
+        ~PoolResource() { release(); }
+        void release();             // free every chunk; blocks must be unused
+
+        // batch interface for ThreadCache: take n blocks of class c as a
+        // linked list, or give back a list ending at last
+        Block * take(int c, int n);
+        void give(int c, Block * first, Block * last);
+        std::pmr::memory_resource * upstream_resource() const { return upstream; }
+    private:
+        Block * freeList[CLASSES];
+        std::vector<std::pair<void *, std::size_t> > chunks;
+        std::size_t chunkSize;      // grows as chunks are added
+        std::pmr::memory_resource * upstream;
+        std::mutex lock;
+        bool sync;
+
+        void refill(int c);
+        void * do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void * p, std::size_t bytes, std::size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+    };
+
+    // one per thread (on its stack, or thread_local); blocks may be freed
+    // through any cache of the same pool, or through the pool itself
+    class ThreadCache : public std::pmr::memory_resource
+    {
+    private:
+        enum { BATCH = 32 };
+        struct Bin { PoolResource::Block * head; int count; };
+        PoolResource & shared;
+        Bin bins[PoolResource::CLASSES];
+
+        void * do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void * p, std::size_t bytes, std::size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+    public:
+        explicit ThreadCache(PoolResource & pool);
+        ThreadCache(const ThreadCache &) = delete;
+        ThreadCache & operator=(const ThreadCache &) = delete;
+        ~ThreadCache();
+        PoolResource & pool() const { return shared; }
+    };
+}   // end namespace ARENA
+#endif
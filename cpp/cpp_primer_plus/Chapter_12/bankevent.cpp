@@ -0,0 +1,51 @@
+// bankevent.cpp -- minute-stepped vs next-event teller simulation
+// compile with banksim.cpp
+// g++ -std=c++11 -O2 -pthread bankevent.cpp banksim.cpp -o bankevent
+#include <iostream>
+#include <cmath>
+#include "banksim.h"
+
+void show(const char * name, const BANKSIM::BatchResult & b)
+{
+    std::cout << "  " << name << "wait " << b.wait.mean << " +- " << b.wait.half_width
+              << ", turnaways " << b.turnaways.mean << " +- " << b.turnaways.half_width
+              << ", line " << b.line.mean << " +- " << b.line.half_width
+              << ", " << b.seconds * 1e3 << " ms\n";
+}
+
+// do the two 95% intervals overlap?
+bool agree(const BANKSIM::Interval & a, const BANKSIM::Interval & b)
+{
+    return std::fabs(a.mean - b.mean) <= a.half_width + b.half_width + 1e-9;
+}
+
+int main()
+{
+    using std::cout;
+    const int replications = 200;
+    cout.precision(4);
+
+    struct Case { int qsize; int hours; double perhour; int tellers; };
+    const Case cases[] = {
+        {10, 1000, 15, 1},      // bank.cpp defaults, longer horizon
+        {10, 1000, 30, 1},      // overloaded single teller
+        {10, 1000, 40, 2},
+        {10, 10000, 2, 1},      // quiet branch: most minutes are empty
+        {10, 10000, 0.5, 1},
+    };
+    bool ok = true;
+    for (const Case & c : cases)
+    {
+        BANKSIM::Params p = {c.qsize, c.hours, c.perhour, c.tellers};
+        BANKSIM::BatchResult m = BANKSIM::run_batch(p, replications, 1, 7, BANKSIM::MINUTES);
+        BANKSIM::BatchResult e = BANKSIM::run_batch(p, replications, 1, 7, BANKSIM::EVENTS);
+        cout << c.perhour << "/hour, " << c.tellers << " teller(s), " << c.hours << " hours\n";
+        show("minutes: ", m);
+        show("events:  ", e);
+        bool same = agree(m.wait, e.wait) && agree(m.turnaways, e.turnaways) && agree(m.line, e.line);
+        ok = ok && same;
+        cout << "  speedup " << m.seconds / e.seconds << "x, statistics "
+             << (same ? "agree" : "DIFFER") << "\n";
+    }
+    return ok ? 0 : 1;
+}
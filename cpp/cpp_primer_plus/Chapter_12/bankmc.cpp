@@ -0,0 +1,85 @@
+// bankmc.cpp -- capacity planning sweep with the BANKSIM batch engine
+// compile with banksim.cpp queue.cpp
+// g++ -std=c++11 -O2 -pthread bankmc.cpp banksim.cpp queue.cpp -o bankmc
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "queue.h"
+#include "banksim.h"
+const int MIN_PER_HR = 60;
+
+bool newcustomer(double x);     // same as bank.cpp
+
+// the bank.cpp loop, returned as minutes simulated per second
+double classic_cycles_per_sec(int qs, int hours, double perhour, long & served)
+{
+    std::srand(1);
+    Queue line(qs);
+    long cyclelimit = MIN_PER_HR * hours;
+    double min_per_cust = MIN_PER_HR / perhour;
+    Item temp;
+    int wait_time = 0;
+    served = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < cyclelimit; cycle++)
+    {
+        if (newcustomer(min_per_cust) && !line.isfull())
+        {
+            temp.set(cycle);
+            line.enqueue(temp);
+        }
+        if (wait_time <= 0 && !line.isempty())
+        {
+            line.dequeue(temp);
+            wait_time = temp.ptime();
+            served++;
+        }
+        if (wait_time > 0)
+            wait_time--;
+    }
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return cyclelimit / d.count();
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    const int replications = 1000;
+    const int hours = 100;
+    cout.precision(3);
+    cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
+
+    cout << "Bank of Heather: " << replications << " replications x "
+         << hours << " hours, " << threads << " thread(s)\n";
+    cout << "tellers perhour   avg wait (min)     turnaways/run      avg line\n";
+    long long cycles = 0;
+    double seconds = 0;
+    for (int tellers = 1; tellers <= 2; tellers++)
+        for (double perhour : {15.0, 20.0, 25.0, 30.0, 40.0})
+        {
+            BANKSIM::Params p = {10, hours, perhour, tellers};
+            BANKSIM::BatchResult b = BANKSIM::run_batch(p, replications, threads, 2024);
+            cout << "   " << tellers << "     " << perhour
+                 << "  " << b.wait.mean << " +- " << b.wait.half_width
+                 << "   " << b.turnaways.mean << " +- " << b.turnaways.half_width
+                 << "   " << b.line.mean << endl;
+            cycles += b.cycles;
+            seconds += b.seconds;
+        }
+
+    long served = 0;
+    double classic = classic_cycles_per_sec(10, 100000, 15, served);
+    cout << "bank.cpp loop:  " << classic / 1e6 << " M cycles/s\n";
+    cout << "batch engine:   " << cycles / seconds / 1e6 << " M cycles/s\n";
+    return 0;
+}
+
+bool newcustomer(double x)
+{
+    return (std::rand() * x / RAND_MAX < 1);
+}
@@ -0,0 +1,210 @@
+// banksim.cpp -- BANKSIM methods
+#include "banksim.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <thread>
+
+namespace BANKSIM
+{
+    const int MIN_PER_HR = 60;
+
+    Result simulate_minutes(const Params & p, std::uint64_t seed)
+    {
+        CounterRng rng(seed);
+        const double arrive_prob = p.perhour / MIN_PER_HR;
+        const int qs = p.qsize > 0 ? p.qsize : 0;
+        // the line holds arrival times in a fixed ring, no per-customer allocation
+        std::vector<long> line(qs > 0 ? qs : 1);
+        std::vector<int> ptime(qs > 0 ? qs : 1);
+        int head = 0, count = 0;
+        std::vector<int> wait_time(p.tellers > 0 ? p.tellers : 1, 0);
+
+        Result r = {0, 0, 0, 0, 0, static_cast<long>(MIN_PER_HR) * p.hours};
+        for (long cycle = 0; cycle < r.cycles; cycle++)
+        {
+            if (rng.uniform() < arrive_prob)        // have newcomer
+            {
+                if (count == qs)
+                    r.turnaways++;
+                else
+                {
+                    r.customers++;
+                    int slot = head + count;
+                    if (slot >= qs)
+                        slot -= qs;
+                    line[slot] = cycle;
+                    ptime[slot] = rng.service_time();
+                    count++;
+                }
+            }
+            for (std::size_t t = 0; t < wait_time.size(); t++)
+            {
+                if (wait_time[t] <= 0 && count > 0)  // attend next customer
+                {
+                    wait_time[t] = ptime[head];
+                    r.line_wait += cycle - line[head];
+                    r.served++;
+                    if (++head == qs)
+                        head = 0;
+                    count--;
+                }
+                if (wait_time[t] > 0)
+                    wait_time[t]--;
+            }
+            r.sum_line += count;
+        }
+        return r;
+    }
+
+    namespace
+    {
+        enum EventType {ARRIVAL, COMPLETION};   // arrivals first within a minute
+
+        struct Event
+        {
+            long time;
+            EventType type;
+            bool operator>(const Event & e) const
+            {
+                return time != e.time ? time > e.time : type > e.type;
+            }
+        };
+
+        // minutes until the next arrival when each minute has probability p
+        long next_gap(CounterRng & rng, double p, double log_q)
+        {
+            if (p >= 1.0)
+                return 1;
+            double u = 1.0 - rng.uniform();             // (0, 1]
+            return 1 + static_cast<long>(std::log(u) / log_q);
+        }
+    }
+
+    Result simulate_events(const Params & p, std::uint64_t seed)
+    {
+        CounterRng rng(seed);
+        const double arrive_prob = p.perhour / MIN_PER_HR;
+        const double log_q = arrive_prob < 1.0 ? std::log1p(-arrive_prob) : 0.0;
+        const int qs = p.qsize > 0 ? p.qsize : 0;
+        std::vector<long> line(qs > 0 ? qs : 1);
+        std::vector<int> ptime(qs > 0 ? qs : 1);
+        int head = 0, count = 0;
+        int free_tellers = p.tellers > 0 ? p.tellers : 1;
+
+        Result r = {0, 0, 0, 0, 0, static_cast<long>(MIN_PER_HR) * p.hours};
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+        if (arrive_prob > 0.0)
+            events.push(Event{next_gap(rng, arrive_prob, log_q) - 1, ARRIVAL});
+
+        long last = 0;          // line length is constant between events
+        while (!events.empty() && events.top().time < r.cycles)
+        {
+            Event e = events.top();
+            events.pop();
+            r.sum_line += count * (e.time - last);
+            last = e.time;
+
+            if (e.type == ARRIVAL)
+            {
+                if (count == qs)
+                    r.turnaways++;
+                else
+                {
+                    r.customers++;
+                    int slot = head + count;
+                    if (slot >= qs)
+                        slot -= qs;
+                    line[slot] = e.time;
+                    ptime[slot] = rng.service_time();
+                    count++;
+                }
+                events.push(Event{e.time + next_gap(rng, arrive_prob, log_q), ARRIVAL});
+            }
+            else
+                free_tellers++;
+
+            // tellers act after every event of this minute has been applied
+            if (!events.empty() && events.top().time == e.time)
+                continue;
+            while (free_tellers > 0 && count > 0)   // attend next customer
+            {
+                free_tellers--;
+                events.push(Event{e.time + ptime[head], COMPLETION});
+                r.line_wait += e.time - line[head];
+                r.served++;
+                if (++head == qs)
+                    head = 0;
+                count--;
+            }
+        }
+        r.sum_line += count * (r.cycles - last);
+        return r;
+    }
+
+    Interval confidence(const std::vector<double> & samples)
+    {
+        Interval ci = {0.0, 0.0};
+        const std::size_t n = samples.size();
+        if (n == 0)
+            return ci;
+        double sum = 0.0;
+        for (double x : samples)
+            sum += x;
+        ci.mean = sum / n;
+        if (n > 1)
+        {
+            double ss = 0.0;
+            for (double x : samples)
+                ss += (x - ci.mean) * (x - ci.mean);
+            ci.half_width = 1.96 * std::sqrt(ss / (n - 1) / n);
+        }
+        return ci;
+    }
+
+    BatchResult run_batch(const Params & p, int replications,
+                          unsigned threads, std::uint64_t seed,
+                          Engine engine)
+    {
+        std::vector<Result> results(replications > 0 ? replications : 0);
+        std::atomic<int> next(0);
+        auto start = std::chrono::steady_clock::now();
+
+        auto worker = [&]() {
+            for (int i = next++; i < replications; i = next++)
+            {
+                CounterRng stream(seed, static_cast<std::uint64_t>(i) << 32);
+                results[i] = engine == EVENTS ? simulate_events(p, stream.next())
+                                              : simulate_minutes(p, stream.next());
+            }
+        };
+        threads = std::max(1u, std::min<unsigned>(threads, replications > 0 ? replications : 1));
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++)
+            pool.emplace_back(worker);
+        worker();
+        for (auto & th : pool)
+            th.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::vector<double> wait, turn, line;
+        BatchResult b;
+        b.replications = replications;
+        b.cycles = 0;
+        for (const Result & r : results)
+        {
+            wait.push_back(r.average_wait());
+            turn.push_back(static_cast<double>(r.turnaways));
+            line.push_back(r.average_line());
+            b.cycles += r.cycles;
+        }
+        b.wait = confidence(wait);
+        b.turnaways = confidence(turn);
+        b.line = confidence(line);
+        b.seconds = elapsed.count();
+        return b;
+    }
+}   // end namespace BANKSIM
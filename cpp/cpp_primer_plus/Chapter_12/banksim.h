@@ -0,0 +1,101 @@
+// banksim.h -- batch Monte Carlo engine for the bank.cpp teller model
+// Same minute-by-minute rules as bank.cpp, but with several tellers, a
+// counter-based random generator per replication, and many independent
+// replications spread over threads. A next-event engine gives the same
+// statistics while doing work only when a customer arrives or leaves.
+#ifndef BANKSIM_H_
+#define BANKSIM_H_
+#include <cstdint>
+#include <vector>
+
+namespace BANKSIM
+{
+    // SplitMix64: the n-th draw is a pure function of (key, n), so every
+    // replication gets its own reproducible stream with no shared state.
+    class CounterRng
+    {
+    private:
+        std::uint64_t key;
+        std::uint64_t counter;
+    public:
+        explicit CounterRng(std::uint64_t k, std::uint64_t start = 0)
+            : key(k), counter(start) { }
+        std::uint64_t next()
+        {
+            std::uint64_t z = key + (++counter) * 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+        double uniform()            // [0, 1)
+        {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+        int service_time()          // 1 - 3 minutes, as Customer::set()
+        {
+            return static_cast<int>(((next() >> 32) * 3) >> 32) + 1;
+        }
+    };
+
+    enum Engine {MINUTES, EVENTS};
+
+    struct Params
+    {
+        int qsize;          // maximum line length
+        int hours;          // simulated hours per replication
+        double perhour;     // average arrivals per hour
+        int tellers;        // number of autotellers
+    };
+
+    // totals from one replication, same counters as bank.cpp
+    struct Result
+    {
+        long customers;     // joined the queue
+        long served;        // served during the simulation
+        long turnaways;     // turned away by full queue
+        long sum_line;      // cumulative line length
+        long line_wait;     // cumulative time in line
+        long cycles;        // minutes simulated
+        double average_wait() const
+        {
+            return served > 0 ? static_cast<double>(line_wait) / served : 0.0;
+        }
+        double average_line() const
+        {
+            return cycles > 0 ? static_cast<double>(sum_line) / cycles : 0.0;
+        }
+    };
+
+    struct Interval
+    {
+        double mean;
+        double half_width;  // 95% confidence half width
+    };
+
+    struct BatchResult
+    {
+        int replications;
+        Interval wait;          // average wait per replication (minutes)
+        Interval turnaways;     // turnaways per replication
+        Interval line;          // average line length
+        long long cycles;       // total minutes simulated
+        double seconds;         // wall-clock time of the batch
+    };
+
+    // one replication, one loop iteration per minute
+    Result simulate_minutes(const Params & p, std::uint64_t seed);
+
+    // one replication, jumping from event to event; arrivals are a
+    // discretized exponential (geometric) gap, which is exactly the
+    // one-arrival-per-minute-with-probability-p process of bank.cpp
+    Result simulate_events(const Params & p, std::uint64_t seed);
+
+    // run replications in parallel; replication i always uses the same
+    // stream, so results do not depend on the thread count
+    BatchResult run_batch(const Params & p, int replications,
+                          unsigned threads, std::uint64_t seed,
+                          Engine engine = MINUTES);
+
+    Interval confidence(const std::vector<double> & samples);
+}   // end namespace BANKSIM
+#endif
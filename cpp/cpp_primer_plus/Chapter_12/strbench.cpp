@@ -0,0 +1,97 @@
+// strbench.cpp -- String (string1.h) vs SSO::String (string2.h) throughput
+// compile with string1.cpp string2.cpp
+// g++ -std=c++11 -O2 strbench.cpp string1.cpp string2.cpp -o strbench
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "string1.h"
+#include "string2.h"
+
+const int NumStrings = 200000;
+
+// lengths drawn from a mix like identifiers / words / sentences / paragraphs
+std::vector<std::string> make_corpus()
+{
+    std::mt19937 rng(2024);
+    std::discrete_distribution<int> bucket({55, 30, 12, 3});
+    std::uniform_int_distribution<int> letter('a', 'z');
+    const int lo[] = {0, 16, 41, 201};
+    const int hi[] = {15, 40, 200, 1000};
+    std::vector<std::string> corpus;
+    corpus.reserve(NumStrings);
+    for (int i = 0; i < NumStrings; i++)
+    {
+        int b = bucket(rng);
+        int n = std::uniform_int_distribution<int>(lo[b], hi[b])(rng);
+        std::string s(n, ' ');
+        for (auto & c : s)
+            c = static_cast<char>(letter(rng));
+        corpus.push_back(std::move(s));
+    }
+    return corpus;
+}
+
+template <typename Fn>
+double mops(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return NumStrings / d.count() / 1e6;
+}
+
+template <typename Str>
+void run(const char * name, const std::vector<std::string> & corpus)
+{
+    using std::cout;
+    std::vector<Str> a, b, c;
+    a.reserve(NumStrings);
+    b.reserve(NumStrings);
+    c.reserve(NumStrings);
+
+    double construct = mops([&] {
+        for (const auto & s : corpus)
+            a.emplace_back(s.c_str());
+    });
+    double copy = mops([&] {
+        for (const auto & s : a)
+            b.emplace_back(s);
+    });
+    double move = mops([&] {
+        for (auto & s : b)
+            c.emplace_back(std::move(s));
+    });
+    long equal = 0;
+    double compare = mops([&] {
+        for (int i = 1; i < NumStrings; i++)
+            equal += (a[i] < a[i - 1]) + (a[i] == c[i]);
+    });
+    double sort = mops([&] { std::sort(c.begin(), c.end()); });
+
+    cout << name << ": construct " << construct << ", copy " << copy
+         << ", move " << move << ", compare " << compare
+         << ", sort " << sort << " M/s (checksum " << equal << ")\n";
+}
+
+int main()
+{
+    using std::cout;
+    std::vector<std::string> corpus = make_corpus();
+    cout << NumStrings << " strings, 55% <= 15 chars, 30% 16-40, 12% 41-200, 3% 201-1000\n";
+    run<String>("String     ", corpus);
+    run<SSO::String>("SSO::String", corpus);
+
+    SSO::String empty, shortstr("short"), longstr("a string long enough to live on the heap");
+    SSO::String moved(std::move(longstr));
+    shortstr = moved;
+    cout << "sizeof(String) = " << sizeof(String)
+         << ", sizeof(SSO::String) = " << sizeof(SSO::String) << "\n";
+    cout << "moved: " << moved << " | source now \"" << longstr << "\" | copy: "
+         << shortstr << " | empty length " << empty.length() << "\n";
+    cout << "SSO::String objects on this thread: " << SSO::String::HowMany() << "\n";
+    return 0;
+}
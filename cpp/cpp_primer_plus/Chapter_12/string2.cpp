@@ -0,0 +1,176 @@
+// string2.cpp -- SSO::String class methods
+#include <cstring>
+#include "string2.h"
+
+namespace SSO
+{
+#if STRING2_COUNT_OBJECTS
+    thread_local int String::num_strings = 0;
+#endif
+
+    int String::HowMany()
+    {
+#if STRING2_COUNT_OBJECTS
+        return num_strings;
+#else
+        return -1;
+#endif
+    }
+
+    // private helpers
+
+    void String::init(const char * s, int n)
+    {
+        len = n;
+        if (n <= INLINE_CAP)
+        {
+            str = buf;                  // no allocation for short strings
+            cap = INLINE_CAP;
+        }
+        else
+        {
+            str = new char[n + 1];
+            cap = n;
+        }
+        std::memcpy(str, s, n);
+        str[n] = '\0';
+    }
+
+    void String::assign(const char * s, int n)
+    {
+        if (n > cap)                    // reuse storage when it fits
+        {
+            char * fresh = new char[n + 1];
+            if (!is_inline())
+                delete [] str;
+            str = fresh;
+            cap = n;
+        }
+        std::memmove(str, s, n);        // s may alias str
+        str[n] = '\0';
+        len = n;
+    }
+
+    // class methods
+
+    String::String(const char * s)
+    {
+        init(s, static_cast<int>(std::strlen(s)));
+        count(1);
+    }
+
+    String::String()
+    {
+        init("", 0);
+        count(1);
+    }
+
+    String::String(const String & st)
+    {
+        init(st.str, st.len);
+        count(1);
+    }
+
+    String::String(String && st) noexcept
+    {
+        len = st.len;
+        if (st.is_inline())
+        {
+            str = buf;
+            cap = INLINE_CAP;
+            std::memcpy(buf, st.buf, len + 1);
+        }
+        else
+        {
+            str = st.str;               // steal the heap block
+            cap = st.cap;
+            st.str = st.buf;            // leave source empty but valid
+            st.cap = INLINE_CAP;
+        }
+        st.len = 0;
+        st.buf[0] = '\0';
+        count(1);
+    }
+
+    String::~String()
+    {
+        if (!is_inline())
+            delete [] str;
+        count(-1);
+    }
+
+    // overloaded operator methods
+
+    String & String::operator=(const String & st)
+    {
+        if (this != &st)
+            assign(st.str, st.len);
+        return *this;
+    }
+
+    String & String::operator=(String && st) noexcept
+    {
+        if (this == &st)
+            return *this;
+        if (!st.is_inline())
+        {
+            if (!is_inline())
+                delete [] str;
+            str = st.str;
+            cap = st.cap;
+            len = st.len;
+            st.str = st.buf;
+            st.cap = INLINE_CAP;
+        }
+        else                            // short source: copy; keep our storage
+        {
+            std::memcpy(str, st.buf, st.len + 1);
+            len = st.len;
+        }
+        st.len = 0;
+        st.str[0] = '\0';
+        return *this;
+    }
+
+    String & String::operator=(const char * s)
+    {
+        assign(s, static_cast<int>(std::strlen(s)));
+        return *this;
+    }
+
+    // overloaded operator friends
+
+    bool operator<(const String &st1, const String &st2)
+    {
+        int n = st1.len < st2.len ? st1.len : st2.len;
+        int cmp = std::memcmp(st1.str, st2.str, n);
+        return cmp < 0 || (cmp == 0 && st1.len < st2.len);
+    }
+
+    bool operator>(const String &st1, const String &st2)
+    {
+        return st2 < st1;
+    }
+
+    bool operator==(const String &st1, const String &st2)
+    {
+        return st1.len == st2.len && std::memcmp(st1.str, st2.str, st1.len) == 0;
+    }
+
+    std::ostream & operator<<(std::ostream & os, const String & st)
+    {
+        os << st.str;
+        return os;
+    }
+
+    std::istream & operator>>(std::istream & is, String & st)
+    {
+        char temp[String::CINLIM];
+        is.get(temp, String::CINLIM);
+        if (is)
+            st = temp;
+        while (is && is.get() != '\n')
+            continue;
+        return is;
+    }
+}   // end namespace SSO
@@ -0,0 +1,63 @@
+// string2.h -- String class with small-string optimization and move semantics
+// Short strings live in an inline buffer; only longer ones go to the heap.
+// Define STRING2_COUNT_OBJECTS to 1 to keep a per-thread object count.
+#ifndef STRING2_H_
+#define STRING2_H_
+#include <iostream>
+#include <cstddef>
+
+#ifndef STRING2_COUNT_OBJECTS
+#define STRING2_COUNT_OBJECTS 0
+#endif
+
+namespace SSO
+{
+    class String
+    {
+    private:
+        enum {INLINE_CAP = 15};         // longest string kept inline
+        static const int CINLIM = 80;   // cin input limit
+        char * str;                     // points to buf or to heap storage
+        int len;                        // length of string
+        int cap;                        // usable capacity (excluding '\0')
+        char buf[INLINE_CAP + 1];       // inline storage for short strings
+#if STRING2_COUNT_OBJECTS
+        static thread_local int num_strings;    // objects on this thread
+#endif
+        bool is_inline() const { return str == buf; }
+        void init(const char * s, int n);       // used by constructors
+        void assign(const char * s, int n);     // used by assignment
+        static void count(int delta)
+        {
+#if STRING2_COUNT_OBJECTS
+            num_strings += delta;
+#else
+            (void) delta;
+#endif
+        }
+    public:
+    // constructors and other methods
+        String(const char * s);         // constructor
+        String();                       // default constructor
+        String(const String &);         // copy constructor
+        String(String &&) noexcept;     // move constructor
+        ~String();                      // destructor
+        int length() const { return len; }
+        const char * c_str() const { return str; }
+    // overloaded operator methods
+        String & operator=(const String &);
+        String & operator=(String &&) noexcept;
+        String & operator=(const char *);
+        char & operator[](int i) { return str[i]; }
+        const char & operator[](int i) const { return str[i]; }
+    // overloaded operator friends
+        friend bool operator<(const String &st, const String &st2);
+        friend bool operator>(const String &st1, const String &st2);
+        friend bool operator==(const String &st, const String &st2);
+        friend std::ostream & operator<<(std::ostream & os, const String & st);
+        friend std::istream & operator>>(std::istream & is, String & st);
+    // static function: objects alive on the calling thread, or -1 if not counted
+        static int HowMany();
+    };
+}   // end namespace SSO
+#endif
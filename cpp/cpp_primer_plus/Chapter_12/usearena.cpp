@@ -0,0 +1,238 @@
+// usearena.cpp -- pmr containers on BumpArena, PoolResource and ThreadCache
+// compile with arena.cpp
+// g++ -std=c++17 -O2 -pthread usearena.cpp arena.cpp -o usearena
+// usage: usearena [strings] [rounds] [threads]
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+#include "arena.h"
+using namespace std;
+const int BUF = 512;
+
+class JustTesting
+{
+private:
+    string words;
+    int number;
+public:
+    JustTesting(const string & s = "Just Testing", int n = 0)
+    {words = s; number = n; cout << words << " constructed\n"; }
+    ~JustTesting() { cout << words << " destroyed\n";}
+    void Show() const { cout << words << ", " << number << endl;}
+};
+
+// placenew2.cpp with the arena keeping track of where the next object goes
+void placement_demo()
+{
+    alignas(alignof(max_align_t)) char buffer[BUF];
+    ARENA::BumpArena arena(buffer, BUF);
+    JustTesting * pc1 = new (arena.allocate(sizeof(JustTesting), alignof(JustTesting)))
+                            JustTesting;
+    JustTesting * pc3 = new (arena.allocate(sizeof(JustTesting), alignof(JustTesting)))
+                            JustTesting("Better Idea", 6);
+    cout << "buffer: " << (void *) buffer << "  pc1: " << pc1 << "  pc3: " << pc3
+         << "  bytes used: " << arena.used() << endl;
+    pc1->Show();
+    pc3->Show();
+    pc3->~JustTesting();    // the arena frees memory, not objects
+    pc1->~JustTesting();
+    cout << endl;
+}
+
+// upstream that remembers the last block it handed out
+class LastBlock : public pmr::memory_resource
+{
+public:
+    char * begin = nullptr;
+    size_t size = 0;
+private:
+    void * do_allocate(size_t bytes, size_t align) override
+    {
+        begin = static_cast<char *>(pmr::new_delete_resource()->allocate(bytes, align));
+        size = bytes;
+        return begin;
+    }
+    void do_deallocate(void * p, size_t bytes, size_t align) override
+        { pmr::new_delete_resource()->deallocate(p, bytes, align); }
+    bool do_is_equal(const pmr::memory_resource & other) const noexcept override
+        { return this == &other; }
+};
+
+bool inside(const void * p, size_t bytes, const char * begin, size_t size)
+{
+    const char * q = static_cast<const char *>(p);
+    return q >= begin && q + bytes <= begin + size;
+}
+
+// aligning the next allocation must not step past the end of the block:
+// a chunk, or a caller's buffer whose size is not a multiple of the alignment
+bool alignment_check()
+{
+    bool ok = true;
+    LastBlock up;
+    ARENA::BumpArena a(64, &up);
+    void * p = a.allocate(5001, 1);
+    ok &= inside(p, 5001, up.begin, up.size);
+    p = a.allocate(8, 8);
+    ok &= inside(p, 8, up.begin, up.size);
+
+    alignas(alignof(max_align_t)) char buffer[BUF];
+    ARENA::BumpArena b(buffer, BUF - 3, &up);
+    p = b.allocate(BUF - 6, 1);
+    ok &= inside(p, BUF - 6, buffer, BUF - 3);
+    p = b.allocate(8, 8);
+    ok &= inside(p, 8, up.begin, up.size) && reinterpret_cast<uintptr_t>(p) % 8 == 0;
+    cout << "alignment at the end of a block: " << (ok ? "ok" : "FAILED") << "\n\n";
+    return ok;
+}
+
+// strings long enough to defeat the small-string optimization
+const char * const Words[] = {
+    "a reasonably long string that needs the heap",
+    "another string of more than fifteen characters",
+    "placement new puts objects where you say",
+    "and the arena remembers where that was" };
+
+double seconds_since(chrono::steady_clock::time_point t)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+size_t strings_std(int n)
+{
+    vector<string> v;
+    for (int i = 0; i < n; i++)
+        v.emplace_back(Words[i % 4]);
+    return v.size();
+}
+
+size_t strings_pmr(int n, pmr::memory_resource * mr)
+{
+    pmr::vector<pmr::string> v(mr);
+    for (int i = 0; i < n; i++)
+        v.emplace_back(Words[i % 4]);
+    return v.size();
+}
+
+size_t map_std(int n)
+{
+    map<int, string> m;
+    for (int i = 0; i < n; i++)
+        m.emplace((i * 7919) % n, Words[i % 4]);
+    return m.size();
+}
+
+size_t map_pmr(int n, pmr::memory_resource * mr)
+{
+    pmr::map<int, pmr::string> m(mr);
+    for (int i = 0; i < n; i++)
+        m.emplace((i * 7919) % n, Words[i % 4]);
+    return m.size();
+}
+
+void report(const char * name, double base, double t)
+{
+    cout << "  " << name << t * 1e3 << " ms (" << base / t << "x)\n";
+}
+
+// Work is strings_pmr or map_pmr; Std is the new/delete version
+template <class Std, class Work>
+void compare(const string & title, int n, int rounds, Std std_work, Work work)
+{
+    cout << title << endl;
+    const size_t expect = std_work(n);
+    bool ok = true;
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+        ok &= std_work(n) == expect;
+    double base = seconds_since(t0);
+    cout << "  new/delete:          " << base * 1e3 << " ms\n";
+
+    {
+        ARENA::BumpArena arena(64 * 1024);
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++)
+        {
+            ok &= work(n, &arena) == expect;
+            arena.release();
+        }
+        report("BumpArena:           ", base, seconds_since(t0));
+    }
+    {
+        ARENA::PoolResource pool;
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++)
+            ok &= work(n, &pool) == expect;
+        report("PoolResource:        ", base, seconds_since(t0));
+    }
+    {
+        pmr::monotonic_buffer_resource mono(64 * 1024);
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++)
+        {
+            ok &= work(n, &mono) == expect;
+            mono.release();
+        }
+        report("std monotonic:       ", base, seconds_since(t0));
+    }
+    {
+        pmr::unsynchronized_pool_resource upool;
+        t0 = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++)
+            ok &= work(n, &upool) == expect;
+        report("std unsync pool:     ", base, seconds_since(t0));
+    }
+    if (!ok)
+        cout << "  size mismatch\n";
+}
+
+int main(int argc, char * argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    unsigned threads = argc > 3 ? atoi(argv[3])
+                                : max(2u, thread::hardware_concurrency());
+
+    placement_demo();
+    if (!alignment_check())
+        return 1;
+
+    compare("vector<string>, " + to_string(n) + " strings x " + to_string(rounds),
+            n, rounds, strings_std, strings_pmr);
+    compare("map<int, string>, " + to_string(n) + " entries x " + to_string(rounds),
+            n, rounds, map_std, map_pmr);
+
+    // every thread builds its own containers
+    cout << "map<int, string> on " << threads << " threads\n";
+    auto run = [&](auto body) {
+        vector<thread> pool;
+        auto t0 = chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; t++)
+            pool.emplace_back(body);
+        for (auto & th : pool)
+            th.join();
+        return seconds_since(t0);
+    };
+    double base = run([&] {
+        for (int r = 0; r < rounds; r++)
+            map_std(n);
+    });
+    cout << "  new/delete:          " << base * 1e3 << " ms\n";
+    ARENA::PoolResource shared(true);
+    report("shared PoolResource: ", base, run([&] {
+        for (int r = 0; r < rounds; r++)
+            map_pmr(n, &shared);
+    }));
+    report("ThreadCache:         ", base, run([&] {
+        ARENA::ThreadCache cache(shared);
+        for (int r = 0; r < rounds; r++)
+            map_pmr(n, &cache);
+    }));
+    return 0;
+}
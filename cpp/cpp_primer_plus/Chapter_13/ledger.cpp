@@ -0,0 +1,227 @@
+// ledger.cpp -- Ledger methods
+#include <iostream>
+#include <cmath>
+#include <thread>
+#include "ledger.h"
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace
+{
+    Cents to_cents(double dollars)
+    {
+        return static_cast<Cents>(std::llround(dollars * 100.0));
+    }
+
+    double to_dollars(Cents c)
+    {
+        return c / 100.0;
+    }
+
+    // a batch touches accounts in no particular order, so the balance a few
+    // transactions ahead is prefetched while the current one is posted
+    const std::size_t LOOKAHEAD = 16;
+
+    template <class Fn>
+    BatchSummary post(TxSpan tx, const Cell<Cents> * bal, std::size_t n,
+                      TxStatus * status, Fn fn)
+    {
+        BatchSummary sum;
+        std::size_t k = 0;
+        for (const Transaction * t = tx.begin(); t != tx.end(); ++t, ++k)
+        {
+#if defined(__GNUC__)
+            if (k + LOOKAHEAD < tx.size() && t[LOOKAHEAD].account < n)
+                __builtin_prefetch(bal + t[LOOKAHEAD].account, 1);
+#endif
+            TxStatus st = fn(*t);
+            sum.applied += (st == TX_OK) | (st == TX_ADVANCE);
+            sum.advances += st == TX_ADVANCE;
+            sum.rejected += st > TX_ADVANCE;
+            if (status)
+                status[k] = st;
+        }
+        return sum;
+    }
+
+    // cut tx into equal pieces, one per thread
+    template <class Fn>
+    BatchSummary split(TxSpan tx, unsigned threads, Fn fn)
+    {
+        if (threads <= 1 || tx.size() < 2 * threads)
+            return fn(tx);
+        std::vector<BatchSummary> part(threads);
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++)
+        {
+            std::size_t lo = tx.size() * t / threads;
+            std::size_t hi = tx.size() * (t + 1) / threads;
+            pool.push_back(std::thread([&part, &fn, tx, t, lo, hi] {
+                part[t] = fn(tx.sub(lo, hi - lo));
+            }));
+        }
+        BatchSummary sum;
+        for (unsigned t = 0; t < threads; t++)
+        {
+            pool[t].join();
+            sum += part[t];
+        }
+        return sum;
+    }
+}
+
+BatchSummary & BatchSummary::operator+=(const BatchSummary & b)
+{
+    applied += b.applied;
+    advances += b.advances;
+    rejected += b.rejected;
+    return *this;
+}
+
+Ledger::Ledger(std::size_t reserve)
+{
+    balance.reserve(reserve);
+    owesBank.reserve(reserve);
+    maxLoan.reserve(reserve);
+    rate.reserve(reserve);
+    loanLock.reserve(reserve);
+    fullName.reserve(reserve);
+    acctNum.reserve(reserve);
+    plus.reserve(reserve);
+}
+
+std::uint32_t Ledger::OpenBrass(const string & s, long an, double bal)
+{
+    std::uint32_t i = OpenBrassPlus(s, an, bal, 0.0, 0.0);
+    plus[i] = 0;
+    return i;
+}
+
+std::uint32_t Ledger::OpenBrassPlus(const string & s, long an, double bal,
+                                    double ml, double r)
+{
+    balance.push_back(Cell<Cents>(to_cents(bal)));
+    owesBank.push_back(Cell<Cents>(0));
+    maxLoan.push_back(to_cents(ml));
+    rate.push_back(r);
+    loanLock.push_back(Cell<bool>(false));
+    fullName.push_back(s);
+    acctNum.push_back(an);
+    plus.push_back(1);
+    return static_cast<std::uint32_t>(fullName.size() - 1);
+}
+
+double Ledger::Balance(std::uint32_t i) const
+{
+    return to_dollars(balance[i].v.load());
+}
+
+double Ledger::Owes(std::uint32_t i) const
+{
+    return to_dollars(owesBank[i].v.load());
+}
+
+void Ledger::ViewAcct(std::uint32_t i) const
+{
+    std::ios_base::fmtflags initialState =
+        cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
+    std::streamsize prec = cout.precision(2);
+    cout << "Client: " << fullName[i] << endl;
+    cout << "Account Number: " << acctNum[i] << endl;
+    cout << "Balance: $" << Balance(i) << endl;
+    if (plus[i])
+    {
+        cout << "Maximum loan: $" << to_dollars(maxLoan[i]) << endl;
+        cout << "Owed to bank: $" << Owes(i) << endl;
+        cout.precision(3);
+        cout << "Loan Rate: " << 100 * rate[i] << "%\n";
+    }
+    cout.setf(initialState, std::ios_base::floatfield);
+    cout.precision(prec);
+}
+
+// Brass::Withdraw and BrassPlus::Withdraw in one: a plain Brass account
+// has maxLoan == 0, so the advance branch can never succeed for it
+TxStatus Ledger::withdraw(std::size_t i, Cents amt)
+{
+    if (amt < 0)
+        return TX_NEGATIVE;
+    std::atomic<Cents> & bal = balance[i].v;
+    Cents b = bal.load(std::memory_order_relaxed);
+    while (amt <= b)
+        if (bal.compare_exchange_weak(b, b - amt, std::memory_order_relaxed))
+            return TX_OK;
+    if (maxLoan[i] == 0)
+        return TX_NO_FUNDS;
+
+    // the advance changes balance and owesBank together; owesBank is only
+    // written under the account's loan lock, balance still by CAS
+    std::atomic<bool> & lock = loanLock[i].v;
+    while (lock.exchange(true, std::memory_order_acquire))
+        std::this_thread::yield();
+    TxStatus st;
+    for (;;)
+    {
+        b = bal.load(std::memory_order_relaxed);
+        if (amt <= b)
+        {
+            if (bal.compare_exchange_weak(b, b - amt, std::memory_order_relaxed))
+            {
+                st = TX_OK;
+                break;
+            }
+            continue;
+        }
+        Cents advance = amt - b;
+        Cents owes = owesBank[i].v.load(std::memory_order_relaxed);
+        if (advance > maxLoan[i] - owes)
+        {
+            st = TX_NO_FUNDS;
+            break;
+        }
+        if (bal.compare_exchange_weak(b, 0, std::memory_order_relaxed))
+        {
+            owesBank[i].v.store(owes + to_cents(to_dollars(advance) * (1.0 + rate[i])),
+                                std::memory_order_relaxed);
+            st = TX_ADVANCE;
+            break;
+        }
+    }
+    lock.store(false, std::memory_order_release);
+    return st;
+}
+
+BatchSummary Ledger::applyDeposits(TxSpan tx, TxStatus * status)
+{
+    const std::size_t n = size();
+    return post(tx, balance.data(), n, status, [this, n](const Transaction & t) {
+        if (t.account >= n)
+            return TX_BAD_ACCOUNT;
+        Cents amt = to_cents(t.amount);
+        if (amt < 0)
+            return TX_NEGATIVE;
+        balance[t.account].v.fetch_add(amt, std::memory_order_relaxed);
+        return TX_OK;
+    });
+}
+
+BatchSummary Ledger::applyWithdrawals(TxSpan tx, TxStatus * status)
+{
+    const std::size_t n = size();
+    return post(tx, balance.data(), n, status, [this, n](const Transaction & t) {
+        if (t.account >= n)
+            return TX_BAD_ACCOUNT;
+        return withdraw(t.account, to_cents(t.amount));
+    });
+}
+
+BatchSummary Ledger::applyDeposits(TxSpan tx, unsigned threads)
+{
+    return split(tx, threads, [this](TxSpan part) { return applyDeposits(part, (TxStatus *) 0); });
+}
+
+BatchSummary Ledger::applyWithdrawals(TxSpan tx, unsigned threads)
+{
+    return split(tx, threads, [this](TxSpan part) { return applyWithdrawals(part, (TxStatus *) 0); });
+}
@@ -0,0 +1,112 @@
+// ledger.h -- columnar account store for Brass / BrassPlus accounts
+// Balances, loan limits and amounts owed sit in parallel arrays ("hot"
+// columns) while names and account numbers are kept apart ("cold").
+// A Brass account is a BrassPlus account with no loan allowance, so one
+// branch-light loop handles both kinds without virtual calls.
+// Money is kept as whole cents in atomics: batches may be posted from
+// several threads at once, even to the same account.
+#ifndef LEDGER_H_
+#define LEDGER_H_
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef std::int64_t Cents;
+
+struct Transaction
+{
+    std::uint32_t account;      // index returned by Ledger::Open...
+    double amount;              // dollars, as for Deposit() / Withdraw()
+};
+
+// minimal read-only view of contiguous transactions (std::span is C++20)
+class TxSpan
+{
+private:
+    const Transaction * first;
+    std::size_t count;
+public:
+    TxSpan(const Transaction * p, std::size_t n) : first(p), count(n) { }
+    TxSpan(const std::vector<Transaction> & v) : first(v.data()), count(v.size()) { }
+    const Transaction * begin() const { return first; }
+    const Transaction * end() const { return first + count; }
+    std::size_t size() const { return count; }
+    TxSpan sub(std::size_t pos, std::size_t n) const { return TxSpan(first + pos, n); }
+};
+
+// atomic that can be copied while no other thread is using it, so the
+// columns can live in std::vector and grow as accounts are opened
+template <class T>
+struct Cell
+{
+    std::atomic<T> v;
+    Cell(T x = T()) : v(x) { }
+    Cell(const Cell & c) : v(c.v.load(std::memory_order_relaxed)) { }
+    Cell & operator=(const Cell & c)
+    {
+        v.store(c.v.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+};
+
+enum TxStatus
+{
+    TX_OK,
+    TX_ADVANCE,         // BrassPlus withdrawal covered by a bank advance
+    TX_NEGATIVE,        // negative amount, cancelled
+    TX_NO_FUNDS,        // balance (and credit) exceeded, cancelled
+    TX_BAD_ACCOUNT      // no such account
+};
+
+struct BatchSummary
+{
+    std::size_t applied;
+    std::size_t advances;
+    std::size_t rejected;
+    BatchSummary() : applied(0), advances(0), rejected(0) { }
+    BatchSummary & operator+=(const BatchSummary & b);
+};
+
+class Ledger
+{
+private:
+    // hot columns, indexed by account
+    std::vector<Cell<Cents> > balance;
+    std::vector<Cell<Cents> > owesBank;
+    std::vector<Cents> maxLoan;             // 0 for plain Brass accounts
+    std::vector<double> rate;
+    std::vector<Cell<bool> > loanLock;      // held while granting an advance
+    // cold columns
+    std::vector<std::string> fullName;
+    std::vector<long> acctNum;
+    std::vector<char> plus;                 // opened as BrassPlus
+
+    TxStatus withdraw(std::size_t i, Cents amt);
+public:
+    explicit Ledger(std::size_t reserve = 0);
+    Ledger(const Ledger &) = delete;
+    Ledger & operator=(const Ledger &) = delete;
+
+    // opening accounts is not thread-safe; posting is
+    std::uint32_t OpenBrass(const std::string & s = "Nullbody", long an = -1,
+                            double bal = 0.0);
+    std::uint32_t OpenBrassPlus(const std::string & s = "Nullbody", long an = -1,
+                                double bal = 0.0, double ml = 500,
+                                double r = 0.11125);
+    std::size_t size() const { return fullName.size(); }
+
+    double Balance(std::uint32_t i) const;
+    double Owes(std::uint32_t i) const;
+    void ViewAcct(std::uint32_t i) const;   // same output as Brass / BrassPlus
+
+    // batch posting; status, when given, receives one entry per transaction
+    BatchSummary applyDeposits(TxSpan tx, TxStatus * status = 0);
+    BatchSummary applyWithdrawals(TxSpan tx, TxStatus * status = 0);
+    // split a batch across threads
+    BatchSummary applyDeposits(TxSpan tx, unsigned threads);
+    BatchSummary applyWithdrawals(TxSpan tx, unsigned threads);
+};
+
+#endif
@@ -0,0 +1,104 @@
+// useledger.cpp -- batched posting with Ledger, compared with Brass objects
+// compile with ledger.cpp brass.cpp
+// g++ -std=c++11 -O2 -pthread useledger.cpp ledger.cpp brass.cpp -o useledger
+// usage: useledger [accounts] [transactions] [threads]
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "brass.h"
+#include "ledger.h"
+
+int main(int argc, char * argv[])
+{
+    using namespace std;
+    size_t accounts = argc > 1 ? strtoul(argv[1], 0, 10) : 1000000;
+    size_t count = argc > 2 ? strtoul(argv[2], 0, 10) : 10000000;
+    unsigned threads = argc > 3 ? strtoul(argv[3], 0, 10)
+                                : max(1u, thread::hardware_concurrency());
+
+    // the usebrass2.cpp clients, one overdraft each way
+    Ledger demo;
+    uint32_t porky = demo.OpenBrass("Porky Pig", 381299, 4000.00);
+    uint32_t hoggy = demo.OpenBrassPlus("Horatio Hogg", 382288, 3000.00);
+    Transaction tx[] = { {porky, 4200.00}, {hoggy, 3300.00}, {hoggy, -1.0} };
+    TxStatus status[3];
+    demo.applyWithdrawals(TxSpan(tx, 3), status);
+    const char * names[] = { "ok", "advance", "negative", "no funds", "bad account" };
+    for (int i = 0; i < 3; i++)
+        cout << "Withdraw $" << tx[i].amount << ": " << names[status[i]] << endl;
+    demo.ViewAcct(porky);
+    cout << endl;
+    demo.ViewAcct(hoggy);
+    cout << endl;
+
+    // every fourth account is a BrassPlus; balances are large enough that
+    // no Brass object ever prints a cancellation message
+    Ledger ledger(accounts);
+    vector<unique_ptr<Brass> > clients;
+    clients.reserve(accounts);
+    for (size_t i = 0; i < accounts; i++)
+    {
+        if (i % 4 == 0)
+        {
+            ledger.OpenBrassPlus("Client", long(i), 1e6);
+            clients.push_back(unique_ptr<Brass>(new BrassPlus("Client", long(i), 1e6)));
+        }
+        else
+        {
+            ledger.OpenBrass("Client", long(i), 1e6);
+            clients.push_back(unique_ptr<Brass>(new Brass("Client", long(i), 1e6)));
+        }
+    }
+    vector<Transaction> batch(count);
+    uint64_t r = 88172645463325252ULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        r ^= r << 13;
+        r ^= r >> 7;
+        r ^= r << 17;
+        batch[i].account = uint32_t((r >> 32) % accounts);
+        batch[i].amount = double(r % 10000) / 100.0;
+    }
+
+    typedef chrono::steady_clock clock;
+    auto start = clock::now();
+    for (size_t i = 0; i < count; i++)
+        clients[batch[i].account]->Deposit(batch[i].amount);
+    for (size_t i = 0; i < count; i++)
+        clients[batch[i].account]->Withdraw(batch[i].amount);
+    chrono::duration<double> objects = clock::now() - start;
+
+    start = clock::now();
+    BatchSummary sum = ledger.applyDeposits(batch);
+    sum += ledger.applyWithdrawals(batch);
+    chrono::duration<double> single = clock::now() - start;
+
+    start = clock::now();
+    BatchSummary par = ledger.applyDeposits(batch, threads);
+    par += ledger.applyWithdrawals(batch, threads);
+    chrono::duration<double> multi = clock::now() - start;
+
+    // each pass deposits and withdraws the same amounts, so balances are back
+    // where they started and must match the Brass objects to the cent
+    size_t mismatches = 0;
+    for (size_t i = 0; i < accounts; i++)
+        if (fabs(ledger.Balance(uint32_t(i)) - clients[i]->Balance()) > 0.005)
+            mismatches++;
+
+    double ops = 2.0 * count;
+    cout << accounts << " accounts, " << count << " deposits + " << count
+         << " withdrawals\n";
+    cout << "Brass objects:      " << ops / objects.count() / 1e6 << " M tx/s\n";
+    cout << "Ledger, 1 thread:   " << ops / single.count() / 1e6 << " M tx/s ("
+         << sum.applied << " applied, " << sum.rejected << " rejected)\n";
+    cout << "Ledger, threads=" << threads << ": " << ops / multi.count() / 1e6
+         << " M tx/s (" << par.applied << " applied, " << par.rejected
+         << " rejected)\n";
+    cout << "balance mismatches: " << mismatches << endl;
+    return mismatches != 0;
+}
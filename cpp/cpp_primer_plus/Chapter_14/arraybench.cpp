@@ -0,0 +1,108 @@
+// arraybench.cpp -- ArrayTP (virtual, always checked) vs ArrayTP2
+// g++ -std=c++14 -O3 -DNDEBUG arraybench.cpp -o arraybench
+#include <iostream>
+#include <chrono>
+#include "arraytp.h"
+#include "arraytp2.h"
+
+const int N = 4096;
+const int REPS = 20000;
+
+template <typename Fn>
+double ns_per_element(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / (double(N) * REPS);
+}
+
+// kept out of line so the compiler cannot see the arrays' dynamic type
+#define NOINLINE __attribute__((noinline))
+
+// c = a * s + b, then a running sum of c
+template <class Arr>
+NOINLINE double axpy_sum(Arr & a, Arr & b, Arr & c, double s)
+{
+    double sum = 0;
+    for (int r = 0; r < REPS; r++)
+    {
+        for (int i = 0; i < N; i++)
+            c[i] = a[i] * s + b[i];
+        sum += c[r % N];
+    }
+    return sum;
+}
+
+NOINLINE double expr_sum(const ArrayTP2<double, N> & a, const ArrayTP2<double, N> & b,
+                ArrayTP2<double, N> & c, double s)
+{
+    double sum = 0;
+    for (int r = 0; r < REPS; r++)
+    {
+        c = a * s + b;
+        sum += c[r % N];
+    }
+    return sum;
+}
+
+NOINLINE double raw_sum(const double * a, const double * b, double * c, double s)
+{
+    double sum = 0;
+    for (int r = 0; r < REPS; r++)
+    {
+        for (int i = 0; i < N; i++)
+            c[i] = a[i] * s + b[i];
+        sum += c[r % N];
+    }
+    return sum;
+}
+
+template <class Arr>
+void fill(Arr & a, Arr & b)
+{
+    for (int i = 0; i < N; i++)
+    {
+        a[i] = i * 0.5;
+        b[i] = N - i;
+    }
+}
+
+constexpr ArrayTP2<int, 4> make_squares()
+{
+    ArrayTP2<int, 4> s;
+    for (int i = 0; i < 4; i++)
+        s[i] = i * i;
+    return s;
+}
+
+int main()
+{
+    using std::cout;
+    static ArrayTP<double, N> a1, b1, c1;
+    static ArrayTP2<double, N> a2, b2, c2;
+    static double a3[N], b3[N], c3[N];
+    fill(a1, b1);
+    fill(a2, b2);
+    for (int i = 0; i < N; i++)
+    {
+        a3[i] = i * 0.5;
+        b3[i] = N - i;
+    }
+    double check = 0;
+    double t1 = ns_per_element([&] { check += axpy_sum<ArrayTP<double, N> >(a1, b1, c1, 1.5); });
+    double t2 = ns_per_element([&] { check += axpy_sum<ArrayTP2<double, N> >(a2, b2, c2, 1.5); });
+    double t3 = ns_per_element([&] { check += expr_sum(a2, b2, c2, 1.5); });
+    double t4 = ns_per_element([&] { check += raw_sum(a3, b3, c3, 1.5); });
+    cout << "c = a * s + b over " << N << " doubles, ns per element\n";
+    cout << "  ArrayTP (virtual, checked): " << t1 << "\n";
+    cout << "  ArrayTP2 operator[]:        " << t2 << "\n";
+    cout << "  ArrayTP2 expression:        " << t3 << "\n";
+    cout << "  raw array:                  " << t4 << "\n";
+    cout << "  alignment of ArrayTP2 data: " << alignof(ArrayTP2<double, N>) << " bytes\n";
+    cout << "(checksum " << check << ")\n";
+
+    constexpr ArrayTP2<int, 4> squares = make_squares();
+    static_assert(squares[3] == 9, "computed at compile time");
+    return 0;
+}
@@ -0,0 +1,163 @@
+// arraytp2.h -- fixed-size array template without virtual calls
+// operator[] is non-virtual and constexpr; the range check is compiled in only
+// when NDEBUG is not defined (use at() for an always-checked access).
+// Storage is aligned for SIMD loads, and arithmetic on arrays of arithmetic
+// types builds expression templates, so a = b * 2.0 + c runs as one loop with
+// no temporary arrays. Sizes are template arguments, so mixing arrays of
+// different sizes is a compile-time error. Needs C++14.
+#ifndef ARRAYTP2_H_
+#define ARRAYTP2_H_
+
+#include <iostream>
+#include <cstdlib>
+#include <type_traits>
+
+template <class T, int n> class ArrayTP2;
+
+namespace arrexpr
+{
+    // base of every array expression: E is the concrete expression type
+    template <class E, class T, int n>
+    struct Expr
+    {
+        constexpr const E & self() const { return static_cast<const E &>(*this); }
+        constexpr T operator[](int i) const { return self()[i]; }
+    };
+
+    // operands: arrays are held by reference, intermediate expressions by
+    // value, so an expression stays valid as long as its arrays do
+    template <class E> struct Operand { typedef const E type; };
+    template <class T, int n> struct Operand<ArrayTP2<T, n> > { typedef const ArrayTP2<T, n> & type; };
+
+    template <class L, class R, class Op, class T, int n>
+    struct Binary : Expr<Binary<L, R, Op, T, n>, T, n>
+    {
+        typename Operand<L>::type l;
+        typename Operand<R>::type r;
+        constexpr Binary(const L & a, const R & b) : l(a), r(b) { }
+        constexpr T operator[](int i) const { return Op::apply(l[i], r[i]); }
+    };
+
+    template <class L, class T, int n>
+    struct ScaledBy : Expr<ScaledBy<L, T, n>, T, n>
+    {
+        typename Operand<L>::type l;
+        T s;
+        constexpr ScaledBy(const L & a, T x) : l(a), s(x) { }
+        constexpr T operator[](int i) const { return l[i] * s; }
+    };
+
+    struct Add { template <class T> static constexpr T apply(T a, T b) { return a + b; } };
+    struct Sub { template <class T> static constexpr T apply(T a, T b) { return a - b; } };
+    struct Mul { template <class T> static constexpr T apply(T a, T b) { return a * b; } };
+    struct Div { template <class T> static constexpr T apply(T a, T b) { return a / b; } };
+}
+
+template <class T, int n>
+class ArrayTP2 : public arrexpr::Expr<ArrayTP2<T, n>, T, n>
+{
+private:
+    static_assert(n > 0, "ArrayTP2 needs at least one element");
+    enum {ALIGN = alignof(T) > 64 ? alignof(T) : 64};
+    alignas(ALIGN) T ar[n];
+    static void out_of_range(int i)
+    {
+        std::cerr << "Error in array limits: " << i
+            << " is out of range\n";
+        std::exit(EXIT_FAILURE);
+    }
+public:
+    constexpr ArrayTP2() : ar() { }
+    constexpr explicit ArrayTP2(const T & v) : ar()
+    {
+        for (int i = 0; i < n; i++)
+            ar[i] = v;
+    }
+    // evaluate an expression element by element, in one pass
+    template <class E>
+    ArrayTP2(const arrexpr::Expr<E, T, n> & e) { assign(e.self()); }
+    template <class E>
+    ArrayTP2 & operator=(const arrexpr::Expr<E, T, n> & e)
+    {
+        assign(e.self());
+        return *this;
+    }
+    ArrayTP2(const ArrayTP2 &) = default;
+    ArrayTP2 & operator=(const ArrayTP2 &) = default;
+
+    static constexpr int size() { return n; }
+    T * data() { return ar; }
+    const T * data() const { return ar; }
+
+    constexpr T & operator[](int i)
+    {
+#ifndef NDEBUG
+        if (i < 0 || i >= n)
+            out_of_range(i);
+#endif
+        return ar[i];
+    }
+    constexpr const T & operator[](int i) const
+    {
+#ifndef NDEBUG
+        if (i < 0 || i >= n)
+            out_of_range(i);
+#endif
+        return ar[i];
+    }
+    T & at(int i)
+    {
+        if (i < 0 || i >= n)
+            out_of_range(i);
+        return ar[i];
+    }
+    const T & at(int i) const
+    {
+        if (i < 0 || i >= n)
+            out_of_range(i);
+        return ar[i];
+    }
+
+private:
+    template <class E>
+    void assign(const E & e)
+    {
+        // element i is computed and stored before element i + 1 is read,
+        // so a = a * 2.0 + b is fine: each element reads only its own index
+        for (int i = 0; i < n; i++)
+            ar[i] = e[i];
+    }
+};
+
+// element-wise operators, enabled only for arithmetic element types
+#define ARRAYTP2_OPERATOR(op, Op)                                                  \
+template <class L, class R, class T, int n,                                        \
+          class = typename std::enable_if<std::is_arithmetic<T>::value>::type>     \
+constexpr arrexpr::Binary<L, R, arrexpr::Op, T, n>                                 \
+operator op(const arrexpr::Expr<L, T, n> & a, const arrexpr::Expr<R, T, n> & b)    \
+{                                                                                  \
+    return arrexpr::Binary<L, R, arrexpr::Op, T, n>(a.self(), b.self());           \
+}
+
+ARRAYTP2_OPERATOR(+, Add)
+ARRAYTP2_OPERATOR(-, Sub)
+ARRAYTP2_OPERATOR(*, Mul)
+ARRAYTP2_OPERATOR(/, Div)
+#undef ARRAYTP2_OPERATOR
+
+// array-scalar products
+template <class L, class T, int n,
+          class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+constexpr arrexpr::ScaledBy<L, T, n> operator*(const arrexpr::Expr<L, T, n> & a, T s)
+{
+    return arrexpr::ScaledBy<L, T, n>(a.self(), s);
+}
+
+template <class L, class T, int n,
+          class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+constexpr arrexpr::ScaledBy<L, T, n> operator*(T s, const arrexpr::Expr<L, T, n> & a)
+{
+    return arrexpr::ScaledBy<L, T, n>(a.self(), s);
+}
+
+#endif
@@ -0,0 +1,140 @@
+// stackbench.cpp -- GrowStack vs std::stack<std::vector> vs the fixed Stack
+// g++ -std=c++11 -O2 stackbench.cpp -o stackbench
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <stack>
+#include <string>
+#include <vector>
+#include "stacktp.h"
+#include "stackgrow.h"
+
+template <typename Fn>
+double ns_per_op(long ops, Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / ops;
+}
+
+// depth items pushed then popped, repeated rounds times
+template <typename Push, typename Pop>
+double churn(long depth, long rounds, Push push, Pop pop)
+{
+    return ns_per_op(2 * depth * rounds, [&] {
+        for (long r = 0; r < rounds; r++)
+        {
+            for (long i = 0; i < depth; i++)
+                push(i);
+            for (long i = 0; i < depth; i++)
+                pop();
+        }
+    });
+}
+
+int main()
+{
+    using std::cout;
+    long sink = 0;
+
+    cout << "ns per push/pop of long\n";
+    cout << "depth\tStack<10>\tGrowStack\tstd::stack\n";
+    for (long depth : {8L, 10L, 1000L, 100000L})
+    {
+        long rounds = 4000000 / depth;
+        double fixed = -1;
+        if (depth <= 10)
+        {
+            Stack<long> st;
+            fixed = churn(depth, rounds, [&](long i) { st.push(i); },
+                          [&] { long v = 0; st.pop(v); sink += v; });
+        }
+        GrowStack<long> gs;
+        double grow = churn(depth, rounds, [&](long i) { gs.push(i); },
+                            [&] { sink += gs.peek(); gs.pop(); });
+        std::stack<long, std::vector<long> > ss;
+        double stdst = churn(depth, rounds, [&](long i) { ss.push(i); },
+                             [&] { sink += ss.top(); ss.pop(); });
+        cout << depth << "\t";
+        if (fixed < 0)
+            cout << "-";
+        else
+            cout << fixed;
+        cout << "\t\t" << grow << "\t\t" << stdst << "\n";
+    }
+
+    // strings: pop(Type&) in stacktp.h copies, GrowStack moves
+    cout << "ns per push/pop of std::string (depth 10)\n";
+    std::string po(40, 'x');
+    {
+        Stack<std::string> st;
+        double t = churn(10, 200000, [&](long) { st.push(po); },
+                         [&] { std::string s; st.pop(s); sink += s.size(); });
+        cout << "Stack<10>  " << t << "\n";
+        GrowStack<std::string> gs;
+        t = churn(10, 200000, [&](long) { gs.emplace(40, 'x'); },
+                  [&] { std::string s; gs.pop(s); sink += s.size(); });
+        cout << "GrowStack  " << t << "\n";
+        std::stack<std::string, std::vector<std::string> > ss;
+        t = churn(10, 200000, [&](long) { ss.emplace(40, 'x'); },
+                  [&] { std::string s = std::move(ss.top()); ss.pop(); sink += s.size(); });
+        cout << "std::stack " << t << "\n";
+    }
+
+    // bulk operations: 100000 items in, then all out top first. Each case
+    // runs once untimed so the storage is already allocated and touched.
+    cout << "ns per item, push 100000 then pop 100000 of long\n";
+    const long items = 100000, reps = 5, rounds = 20;
+    std::vector<long> src(items), dst(items);
+    for (long i = 0; i < items; i++)
+        src[i] = i;
+    auto warm = [&](std::function<void()> round) {
+        round();
+        double best = 1e30;
+        for (long r = 0; r < reps; r++)
+        {
+            double t = ns_per_op(2 * items * rounds, [&] {
+                for (long k = 0; k < rounds; k++)
+                    round();
+            });
+            best = std::min(best, t);
+        }
+        sink += dst[0];
+        return best;
+    };
+    GrowStack<long> bulk;
+    cout << "GrowStack push_range/pop_n   " << warm([&] {
+        bulk.push_range(src.begin(), src.end());
+        bulk.pop_n(items, dst.data());
+    }) << "\n";
+    cout << "GrowStack push/pop loop      " << warm([&] {
+        for (long i = 0; i < items; i++)
+            bulk.push(src[i]);
+        for (long i = 0; i < items; i++)
+        {
+            dst[i] = bulk.peek();
+            bulk.pop();
+        }
+    }) << "\n";
+    std::stack<long, std::vector<long> > sbulk;
+    cout << "std::stack push/pop loop     " << warm([&] {
+        for (long i = 0; i < items; i++)
+            sbulk.push(src[i]);
+        for (long i = 0; i < items; i++)
+        {
+            dst[i] = sbulk.top();
+            sbulk.pop();
+        }
+    }) << "\n";
+    std::vector<long> vbulk;
+    cout << "vector insert/reverse copy   " << warm([&] {
+        vbulk.insert(vbulk.end(), src.begin(), src.end());
+        std::copy(vbulk.rbegin(), vbulk.rend(), dst.begin());
+        vbulk.clear();
+    }) << "\n";
+    cout << "first popped " << dst.front() << "\n";
+    cout << "(checksum " << sink << ")\n";
+    return 0;
+}
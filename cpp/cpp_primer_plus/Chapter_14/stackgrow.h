@@ -0,0 +1,256 @@
+// stackgrow.h -- a growable stack template with inline small capacity
+// The first InlineCap items live inside the object; after that the stack
+// spills to a heap block that doubles in size. Items are moved, not copied,
+// when the block grows and when they are popped.
+#ifndef STACKGROW_H_
+#define STACKGROW_H_
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+template <class Type, std::size_t InlineCap = 8>
+class GrowStack
+{
+private:
+    typedef typename std::aligned_storage<sizeof(Type), alignof(Type)>::type Slot;
+    Slot local[InlineCap > 0 ? InlineCap : 1];  // inline storage
+    // pointers rather than counts: a count of the same type as Type
+    // (say long) could alias the items and force reloads after each store
+    Type * items;           // local storage or heap block
+    Type * top;             // one past the top item
+    Type * limit;           // end of storage
+    Type * inline_items() { return reinterpret_cast<Type *>(local); }
+    bool on_heap() const { return items != reinterpret_cast<const Type *>(local); }
+    void grow(std::size_t need);                // geometric growth
+    void destroy_all();
+    void release();                             // free heap block, back to inline
+    void take(GrowStack & st);                  // move st's items into empty *this
+public:
+    GrowStack();
+    GrowStack(const GrowStack & st);
+    GrowStack(GrowStack && st) noexcept(std::is_nothrow_move_constructible<Type>::value);
+    GrowStack & operator=(const GrowStack & st);
+    GrowStack & operator=(GrowStack && st) noexcept(std::is_nothrow_move_constructible<Type>::value);
+    ~GrowStack();
+    bool isempty() const { return top == items; }
+    bool isfull() const { return false; }       // only limited by memory
+    std::size_t size() const { return top - items; }
+    std::size_t capacity() const { return limit - items; }
+    void reserve(std::size_t n) { if (n > capacity()) grow(n); }
+    bool push(const Type & item);               // add item to stack
+    bool push(Type && item);
+    template <class... Args>
+    Type & emplace(Args &&... args);            // construct item in place
+    bool pop(Type & item);                      // move top into item
+    void pop();                                 // discard top item; must not be empty
+    Type & peek() { return top[-1]; }
+    const Type & peek() const { return top[-1]; }
+    // push [first, last); the range must not refer to items of this stack
+    template <class InputIt>
+    void push_range(InputIt first, InputIt last);
+    // pop up to n items (top first) into out; returns how many were popped
+    template <class OutputIt>
+    std::size_t pop_n(std::size_t n, OutputIt out);
+};
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap>::GrowStack()
+    : items(inline_items()), top(items), limit(items + InlineCap)
+{
+}
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap>::GrowStack(const GrowStack & st) : GrowStack()
+{
+    reserve(st.size());
+    for (const Type * p = st.items; p != st.top; ++p, ++top)
+        ::new (static_cast<void *>(top)) Type(*p);
+}
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap>::GrowStack(GrowStack && st)
+    noexcept(std::is_nothrow_move_constructible<Type>::value) : GrowStack()
+{
+    take(st);
+}
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap> & GrowStack<Type, InlineCap>::operator=(const GrowStack & st)
+{
+    if (this != &st)
+    {
+        GrowStack tmp(st);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap> & GrowStack<Type, InlineCap>::operator=(GrowStack && st)
+    noexcept(std::is_nothrow_move_constructible<Type>::value)
+{
+    if (this != &st)
+    {
+        destroy_all();
+        release();
+        take(st);
+    }
+    return *this;
+}
+
+template <class Type, std::size_t InlineCap>
+GrowStack<Type, InlineCap>::~GrowStack()
+{
+    destroy_all();
+    release();
+}
+
+template <class Type, std::size_t InlineCap>
+void GrowStack<Type, InlineCap>::release()
+{
+    if (on_heap())
+    {
+        ::operator delete(items);
+        items = top = inline_items();
+        limit = items + InlineCap;
+    }
+}
+
+template <class Type, std::size_t InlineCap>
+void GrowStack<Type, InlineCap>::take(GrowStack & st)
+{
+    if (st.on_heap())               // steal the heap block
+    {
+        items = st.items;
+        top = st.top;
+        limit = st.limit;
+        st.items = st.top = st.inline_items();
+        st.limit = st.items + InlineCap;
+    }
+    else                            // inline items must be moved one by one
+    {
+        for (Type * p = st.items; p != st.top; ++p, ++top)
+            ::new (static_cast<void *>(top)) Type(std::move(*p));
+        st.destroy_all();
+    }
+}
+
+template <class Type, std::size_t InlineCap>
+void GrowStack<Type, InlineCap>::destroy_all()
+{
+    while (top != items)
+        (--top)->~Type();
+}
+
+template <class Type, std::size_t InlineCap>
+void GrowStack<Type, InlineCap>::grow(std::size_t need)
+{
+    std::size_t n = size();
+    std::size_t newcap = capacity() > 0 ? capacity() : 1;
+    while (newcap < need)
+        newcap *= 2;
+    Type * block = static_cast<Type *>(::operator new(newcap * sizeof(Type)));
+    std::size_t moved = 0;
+    try
+    {
+        for (; moved < n; moved++)
+            ::new (static_cast<void *>(block + moved)) Type(std::move_if_noexcept(items[moved]));
+    }
+    catch (...)
+    {
+        while (moved > 0)
+            block[--moved].~Type();
+        ::operator delete(block);
+        throw;
+    }
+    destroy_all();
+    if (on_heap())
+        ::operator delete(items);
+    items = block;
+    top = block + n;
+    limit = block + newcap;
+}
+
+template <class Type, std::size_t InlineCap>
+bool GrowStack<Type, InlineCap>::push(const Type & item)
+{
+    emplace(item);
+    return true;
+}
+
+template <class Type, std::size_t InlineCap>
+bool GrowStack<Type, InlineCap>::push(Type && item)
+{
+    emplace(std::move(item));
+    return true;
+}
+
+template <class Type, std::size_t InlineCap>
+template <class... Args>
+Type & GrowStack<Type, InlineCap>::emplace(Args &&... args)
+{
+    if (top == limit)
+    {
+        // args may refer to an item already on the stack: build it first
+        Type tmp(std::forward<Args>(args)...);
+        grow(size() + 1);
+        ::new (static_cast<void *>(top)) Type(std::move(tmp));
+    }
+    else
+        ::new (static_cast<void *>(top)) Type(std::forward<Args>(args)...);
+    return *top++;
+}
+
+template <class Type, std::size_t InlineCap>
+bool GrowStack<Type, InlineCap>::pop(Type & item)
+{
+    if (top == items)
+        return false;
+    item = std::move(top[-1]);
+    (--top)->~Type();
+    return true;
+}
+
+template <class Type, std::size_t InlineCap>
+void GrowStack<Type, InlineCap>::pop()
+{
+    (--top)->~Type();
+}
+
+template <class Type, std::size_t InlineCap>
+template <class InputIt>
+void GrowStack<Type, InlineCap>::push_range(InputIt first, InputIt last)
+{
+    typedef typename std::iterator_traits<InputIt>::iterator_category cat;
+    if (std::is_base_of<std::forward_iterator_tag, cat>::value)
+    {
+        // grow once, then copy in one go: a memmove for trivially copyable items
+        reserve(size() + static_cast<std::size_t>(std::distance(first, last)));
+        top = std::uninitialized_copy(first, last, top);
+    }
+    else
+        for (; first != last; ++first)
+            emplace(*first);
+}
+
+template <class Type, std::size_t InlineCap>
+template <class OutputIt>
+std::size_t GrowStack<Type, InlineCap>::pop_n(std::size_t n, OutputIt out)
+{
+    std::size_t count = n < size() ? n : size();
+    Type * stop = top - count;
+    typedef std::reverse_iterator<Type *> down;
+    std::copy(std::make_move_iterator(down(top)), std::make_move_iterator(down(stop)), out);
+    if (std::is_trivially_destructible<Type>::value)
+        top = stop;
+    else
+        while (top != stop)
+            (--top)->~Type();
+    return count;
+}
+
+#endif
@@ -0,0 +1,109 @@
+// queuebench.cpp -- linked QueueTP vs RingQueue vs RingQueue<SPSC>
+// g++ -std=c++11 -O2 -pthread queuebench.cpp -o queuebench
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "queuetp.h"
+#include "queuering.h"
+
+const long OPS = 4000000;
+
+template <typename Fn>
+double ns_per_op(long ops, Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / ops;
+}
+
+// keep depth items queued, then alternate enqueue/dequeue
+template <class Q, class Item>
+double steady_state(Q & q, int depth, const Item & value, long & sink)
+{
+    Item out;
+    for (int i = 0; i < depth; i++)
+        q.enqueue(value);
+    double t = ns_per_op(2 * OPS, [&] {
+        for (long i = 0; i < OPS; i++)
+        {
+            q.enqueue(value);
+            q.dequeue(out);
+            sink += sizeof(out);
+        }
+    });
+    while (q.dequeue(out))
+        continue;
+    return t;
+}
+
+// one producer thread, one consumer thread, OPS items
+template <class Enq, class Deq>
+double cross_thread(Enq enq, Deq deq, long & sink)
+{
+    return ns_per_op(OPS, [&] {
+        std::thread producer([&] {
+            for (long i = 0; i < OPS; i++)
+                while (!enq(i))
+                    std::this_thread::yield();
+        });
+        long got = 0, v = 0;
+        while (got < OPS)
+        {
+            if (deq(v))
+            {
+                sink += v;
+                ++got;
+            }
+            else
+                std::this_thread::yield();
+        }
+        producer.join();
+    });
+}
+
+int main()
+{
+    using std::cout;
+    long sink = 0;
+    const int qs = 1024;
+
+    cout << "single thread, ns per enqueue or dequeue\n";
+    for (int depth : {0, 100, 1000})
+    {
+        QueueTP<long> linked(qs);
+        RingQueue<long> ring(qs);
+        double a = steady_state(linked, depth, 42L, sink);
+        double b = steady_state(ring, depth, 42L, sink);
+        cout << "  long, depth " << depth << ": QueueTP " << a << ", RingQueue " << b << "\n";
+    }
+    {
+        QueueTP<std::string> linked(qs);
+        RingQueue<std::string> ring(qs);
+        std::string s(32, 'x');
+        double a = steady_state(linked, 100, s, sink);
+        double b = steady_state(ring, 100, s, sink);
+        cout << "  string, depth 100: QueueTP " << a << ", RingQueue " << b << "\n";
+    }
+
+    cout << "producer -> consumer threads, ns per item\n";
+    {
+        QueueTP<long> linked(qs);
+        std::mutex m;
+        double t = cross_thread(
+            [&](long v) { std::lock_guard<std::mutex> lock(m); return linked.enqueue(v); },
+            [&](long & v) { std::lock_guard<std::mutex> lock(m); return linked.dequeue(v); },
+            sink);
+        cout << "  QueueTP + mutex: " << t << "\n";
+    }
+    {
+        RingQueue<long, SPSC> ring(qs);
+        double t = cross_thread([&](long v) { return ring.enqueue(v); },
+                                [&](long & v) { return ring.dequeue(v); }, sink);
+        cout << "  RingQueue<SPSC>: " << t << "\n";
+    }
+    cout << "(checksum " << sink << ")\n";
+    return 0;
+}
@@ -0,0 +1,166 @@
+// queuering.h -- ring-buffer queue template with the QueueTP interface
+// Items live in one power-of-two array indexed with a mask, so enqueue and
+// dequeue never allocate. RingQueue<Item, SPSC> is a lock-free version for
+// exactly one producer thread and one consumer thread.
+#ifndef QUEUERING_H_
+#define QUEUERING_H_
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+enum QueueMode {SINGLE_THREAD, SPSC};
+
+namespace ringdetail
+{
+    inline std::size_t pow2_at_least(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    // raw storage for cap items; items are constructed on enqueue
+    template <class Item>
+    Item * allocate(std::size_t cap)
+    {
+        return static_cast<Item *>(::operator new(cap * sizeof(Item)));
+    }
+}
+
+template <class Item, QueueMode Mode = SINGLE_THREAD>
+class RingQueue
+{
+private:
+    enum {Q_SIZE = 10};
+    Item * slots;           // power-of-two ring
+    std::size_t mask;       // capacity - 1
+    std::size_t head;       // next item to dequeue
+    std::size_t tail;       // next free slot
+    const int qsize;        // maximum number of items in queue
+    RingQueue(const RingQueue &);
+    RingQueue & operator=(const RingQueue &);
+public:
+    RingQueue(int qs = Q_SIZE)
+        : slots(ringdetail::allocate<Item>(ringdetail::pow2_at_least(qs > 0 ? qs : 1))),
+          mask(ringdetail::pow2_at_least(qs > 0 ? qs : 1) - 1),
+          head(0), tail(0), qsize(qs > 0 ? qs : 1) { }
+    ~RingQueue()
+    {
+        for (; head != tail; ++head)
+            slots[head & mask].~Item();
+        ::operator delete(slots);
+    }
+    bool isempty() const { return head == tail; }
+    bool isfull() const { return queuecount() == qsize; }
+    int queuecount() const { return static_cast<int>(tail - head); }
+    bool enqueue(const Item & item)     // add item to end
+    {
+        if (isfull())
+            return false;
+        ::new (static_cast<void *>(slots + (tail & mask))) Item(item);
+        ++tail;
+        return true;
+    }
+    bool enqueue(Item && item)
+    {
+        if (isfull())
+            return false;
+        ::new (static_cast<void *>(slots + (tail & mask))) Item(std::move(item));
+        ++tail;
+        return true;
+    }
+    bool dequeue(Item & item)           // remove item from front
+    {
+        if (isempty())
+            return false;
+        Item & slot = slots[head & mask];
+        item = std::move(slot);
+        slot.~Item();
+        ++head;
+        return true;
+    }
+};
+
+// Lock-free single-producer/single-consumer ring.
+// Only the producer may call enqueue() and only the consumer dequeue().
+// Each side keeps a private copy of the other side's index and re-reads the
+// shared atomic only when the copy says the ring looks full (or empty), so
+// the cache line owned by the other thread is touched rarely.
+template <class Item>
+class RingQueue<Item, SPSC>
+{
+private:
+    enum {Q_SIZE = 10, LINE = 64};
+    Item * const slots;
+    const std::size_t mask;
+    const std::size_t qsize;
+    // consumer side
+    alignas(LINE) std::atomic<std::size_t> head;
+    std::size_t cached_tail;
+    // producer side
+    alignas(LINE) std::atomic<std::size_t> tail;
+    std::size_t cached_head;
+    char pad[LINE - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+    RingQueue(const RingQueue &);
+    RingQueue & operator=(const RingQueue &);
+public:
+    RingQueue(int qs = Q_SIZE)
+        : slots(ringdetail::allocate<Item>(ringdetail::pow2_at_least(qs > 0 ? qs : 1))),
+          mask(ringdetail::pow2_at_least(qs > 0 ? qs : 1) - 1),
+          qsize(static_cast<std::size_t>(qs > 0 ? qs : 1)),
+          head(0), cached_tail(0), tail(0), cached_head(0) { }
+    ~RingQueue()
+    {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        for (; h != t; ++h)
+            slots[h & mask].~Item();
+        ::operator delete(slots);
+    }
+    // the following three are snapshots when the other thread is active
+    bool isempty() const { return queuecount() == 0; }
+    bool isfull() const { return queuecount() == static_cast<int>(qsize); }
+    int queuecount() const
+    {
+        std::size_t t = tail.load(std::memory_order_acquire);
+        std::size_t h = head.load(std::memory_order_acquire);
+        return static_cast<int>(t - h);
+    }
+    bool enqueue(const Item & item)
+    {
+        Item copy(item);
+        return enqueue(std::move(copy));
+    }
+    bool enqueue(Item && item)          // producer only
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == qsize)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head == qsize)
+                return false;
+        }
+        ::new (static_cast<void *>(slots + (t & mask))) Item(std::move(item));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool dequeue(Item & item)           // consumer only
+    {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h == cached_tail)
+                return false;
+        }
+        Item & slot = slots[h & mask];
+        item = std::move(slot);
+        slot.~Item();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
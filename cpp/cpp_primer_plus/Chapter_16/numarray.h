@@ -0,0 +1,338 @@
+// numarray.h -- valarray-like numeric array with fused expressions (C++14)
+// Arithmetic on NumArray, and on slice and gslice views of one, builds
+// expression templates. results = numbers + 2.0 * sqrt(sq) therefore runs
+// as a single loop that the compiler vectorizes, with no temporary arrays.
+// Large assignments are split across threads. Slices are views: nothing is
+// copied until a result is stored.
+// As with valarray, operand sizes must agree. The destination may appear on
+// the right-hand side only at the same index (a = a * 2.0 + b). Expressions
+// hold arrays and gslice views by reference, so evaluate them in the
+// statement that builds them.
+// vectorizing sqrt and friends needs -fno-math-errno (or -ffast-math)
+#ifndef NUMARRAY_H_
+#define NUMARRAY_H_
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <thread>
+#include <type_traits>
+#include <valarray>         // std::slice, std::gslice
+#include <vector>
+
+template <class T> class NumArray;
+template <class T> class SliceView;
+template <class T> class GSliceView;
+
+namespace numexpr
+{
+    // base of every expression; E is the concrete type
+    template <class E>
+    struct Expr
+    {
+        const E & self() const { return static_cast<const E &>(*this); }
+        std::size_t size() const { return self().size(); }
+    };
+
+    template <class T>
+    struct Scalar : Expr<Scalar<T> >
+    {
+        typedef T value_type;
+        T v;
+        explicit Scalar(T x) : v(x) { }
+        T operator[](std::size_t) const { return v; }
+        std::size_t size() const { return 0; }      // takes the other side's
+    };
+
+    // arrays and gslice views (which own an index table) are held by
+    // reference, everything else by value
+    template <class E> struct Operand { typedef const E type; };
+    template <class T> struct Operand<NumArray<T> > { typedef const NumArray<T> & type; };
+    template <class T> struct Operand<GSliceView<T> > { typedef const GSliceView<T> & type; };
+
+    template <class L, class R, class Op>
+    struct Binary : Expr<Binary<L, R, Op> >
+    {
+        typedef typename L::value_type value_type;
+        typename Operand<L>::type l;
+        typename Operand<R>::type r;
+        Binary(const L & a, const R & b) : l(a), r(b) { }
+        value_type operator[](std::size_t i) const { return Op::apply(l[i], r[i]); }
+        std::size_t size() const { return l.size() ? l.size() : r.size(); }
+    };
+
+    template <class A, class Op>
+    struct Unary : Expr<Unary<A, Op> >
+    {
+        typedef typename A::value_type value_type;
+        typename Operand<A>::type a;
+        explicit Unary(const A & x) : a(x) { }
+        value_type operator[](std::size_t i) const { return Op::apply(a[i]); }
+        std::size_t size() const { return a.size(); }
+    };
+
+    struct Add { template <class T> static T apply(T a, T b) { return a + b; } };
+    struct Sub { template <class T> static T apply(T a, T b) { return a - b; } };
+    struct Mul { template <class T> static T apply(T a, T b) { return a * b; } };
+    struct Div { template <class T> static T apply(T a, T b) { return a / b; } };
+    struct Neg { template <class T> static T apply(T a) { return -a; } };
+    struct Sqrt { template <class T> static T apply(T a) { using std::sqrt; return sqrt(a); } };
+    struct Abs { template <class T> static T apply(T a) { using std::abs; return abs(a); } };
+    struct Exp { template <class T> static T apply(T a) { using std::exp; return exp(a); } };
+    struct Log { template <class T> static T apply(T a) { using std::log; return log(a); } };
+    struct Sin { template <class T> static T apply(T a) { using std::sin; return sin(a); } };
+    struct Cos { template <class T> static T apply(T a) { using std::cos; return cos(a); } };
+
+    // parallel evaluation: below THRESHOLD elements, or with one thread,
+    // the loop runs on the calling thread
+    struct Parallel
+    {
+        static unsigned & threads()
+        {
+            static unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            return n;
+        }
+        enum { THRESHOLD = 1 << 18 };
+    };
+
+    template <class Body>
+    void for_range(std::size_t n, Body body)
+    {
+        unsigned t = Parallel::threads();
+        if (t <= 1 || n < std::size_t(Parallel::THRESHOLD))
+        {
+            body(std::size_t(0), n);
+            return;
+        }
+        t = unsigned(std::min<std::size_t>(t, n / (Parallel::THRESHOLD / 4)));
+        std::vector<std::thread> pool;
+        // pieces end on multiples of 64 elements so threads do not share
+        // cache lines of the destination
+        std::size_t step = (n / t + 63) / 64 * 64;
+        for (unsigned k = 1; k < t && k * step < n; k++)
+            pool.push_back(std::thread(body, k * step, std::min(n, (k + 1) * step)));
+        body(std::size_t(0), std::min(n, step));
+        for (std::size_t k = 0; k < pool.size(); k++)
+            pool[k].join();
+    }
+
+    template <class E>
+    typename E::value_type reduce_sum(const E & e)
+    {
+        typename E::value_type s = typename E::value_type();
+        for (std::size_t i = 0, n = e.size(); i < n; i++)
+            s += e[i];
+        return s;
+    }
+}   // end namespace numexpr
+
+// strided view: elements start, start + stride, ... of an array
+template <class T>
+class SliceView : public numexpr::Expr<SliceView<T> >
+{
+private:
+    T * base;
+    std::size_t n;
+    std::size_t stride;
+public:
+    typedef T value_type;
+    SliceView(T * p, const std::slice & s)
+        : base(p + s.start()), n(s.size()), stride(s.stride()) { }
+    SliceView(const SliceView &) = default;
+    std::size_t size() const { return n; }
+    T & operator[](std::size_t i) const { return base[i * stride]; }
+
+    template <class E>
+    const SliceView & operator=(const numexpr::Expr<E> & e) const
+    {
+        const E & x = e.self();
+        T * b = base;
+        std::size_t st = stride;
+        numexpr::for_range(n, [b, st, &x](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++)
+                b[i * st] = x[i];
+        });
+        return *this;
+    }
+    const SliceView & operator=(const SliceView & v) const
+    {
+        return *this = static_cast<const numexpr::Expr<SliceView> &>(v);
+    }
+    const SliceView & operator=(T v) const { return *this = numexpr::Scalar<T>(v); }
+};
+
+// general slice: the element positions are worked out once, as in valarray
+template <class T>
+class GSliceView : public numexpr::Expr<GSliceView<T> >
+{
+private:
+    T * base;
+    std::vector<std::size_t> index;
+public:
+    typedef T value_type;
+    GSliceView(T * p, const std::gslice & g) : base(p)
+    {
+        const std::valarray<std::size_t> len = g.size();
+        const std::valarray<std::size_t> str = g.stride();
+        std::size_t total = len.size() ? 1 : 0;
+        for (std::size_t d = 0; d < len.size(); d++)
+            total *= len[d];
+        index.resize(total);
+        std::vector<std::size_t> at(len.size(), 0);
+        for (std::size_t k = 0; k < total; k++)
+        {
+            std::size_t pos = g.start();
+            for (std::size_t d = 0; d < len.size(); d++)
+                pos += at[d] * str[d];
+            index[k] = pos;
+            for (std::size_t d = len.size(); d-- > 0; )     // last dimension fastest
+            {
+                if (++at[d] < len[d])
+                    break;
+                at[d] = 0;
+            }
+        }
+    }
+    GSliceView(const GSliceView &) = default;
+    std::size_t size() const { return index.size(); }
+    T & operator[](std::size_t i) const { return base[index[i]]; }
+
+    template <class E>
+    const GSliceView & operator=(const numexpr::Expr<E> & e) const
+    {
+        const E & x = e.self();
+        T * b = base;
+        const std::size_t * ix = index.data();
+        numexpr::for_range(index.size(), [b, ix, &x](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++)
+                b[ix[i]] = x[i];
+        });
+        return *this;
+    }
+    const GSliceView & operator=(const GSliceView & g) const
+    {
+        return *this = static_cast<const numexpr::Expr<GSliceView> &>(g);
+    }
+    const GSliceView & operator=(T v) const { return *this = numexpr::Scalar<T>(v); }
+};
+
+template <class T>
+class NumArray : public numexpr::Expr<NumArray<T> >
+{
+private:
+    std::vector<T> v;
+
+    template <class E>
+    void assign(const E & e)
+    {
+        T * d = v.data();
+        numexpr::for_range(v.size(), [d, &e](std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++)
+                d[i] = e[i];
+        });
+    }
+public:
+    typedef T value_type;
+    NumArray() { }
+    explicit NumArray(std::size_t n) : v(n) { }
+    NumArray(const T & x, std::size_t n) : v(n, x) { }     // valarray order
+    NumArray(const T * p, std::size_t n) : v(p, p + n) { }
+    NumArray(std::initializer_list<T> il) : v(il) { }
+    template <class E>
+    NumArray(const numexpr::Expr<E> & e) : v(e.size()) { assign(e.self()); }
+
+    template <class E>
+    NumArray & operator=(const numexpr::Expr<E> & e)
+    {
+        if (e.size() != v.size())
+        {
+            NumArray tmp(e);            // like valarray: resize to fit
+            v.swap(tmp.v);
+        }
+        else
+            assign(e.self());
+        return *this;
+    }
+    NumArray & operator=(const T & x)
+    {
+        std::fill(v.begin(), v.end(), x);
+        return *this;
+    }
+    template <class E> NumArray & operator+=(const numexpr::Expr<E> & e)
+        { assign(numexpr::Binary<NumArray, E, numexpr::Add>(*this, e.self())); return *this; }
+    template <class E> NumArray & operator-=(const numexpr::Expr<E> & e)
+        { assign(numexpr::Binary<NumArray, E, numexpr::Sub>(*this, e.self())); return *this; }
+    template <class E> NumArray & operator*=(const numexpr::Expr<E> & e)
+        { assign(numexpr::Binary<NumArray, E, numexpr::Mul>(*this, e.self())); return *this; }
+    template <class E> NumArray & operator/=(const numexpr::Expr<E> & e)
+        { assign(numexpr::Binary<NumArray, E, numexpr::Div>(*this, e.self())); return *this; }
+    NumArray & operator+=(const T & x) { return *this += numexpr::Scalar<T>(x); }
+    NumArray & operator-=(const T & x) { return *this -= numexpr::Scalar<T>(x); }
+    NumArray & operator*=(const T & x) { return *this *= numexpr::Scalar<T>(x); }
+    NumArray & operator/=(const T & x) { return *this /= numexpr::Scalar<T>(x); }
+
+    std::size_t size() const { return v.size(); }
+    void resize(std::size_t n, T x = T()) { v.assign(n, x); }
+    T * data() { return v.data(); }
+    const T * data() const { return v.data(); }
+    T & operator[](std::size_t i) { return v[i]; }
+    const T & operator[](std::size_t i) const { return v[i]; }
+    SliceView<T> operator[](const std::slice & s) { return SliceView<T>(v.data(), s); }
+    GSliceView<T> operator[](const std::gslice & g) { return GSliceView<T>(v.data(), g); }
+
+    T sum() const { return numexpr::reduce_sum(*this); }
+    T min() const { return *std::min_element(v.begin(), v.end()); }
+    T max() const { return *std::max_element(v.begin(), v.end()); }
+};
+
+// sum of any expression, without storing it
+template <class E>
+typename E::value_type sum(const numexpr::Expr<E> & e) { return numexpr::reduce_sum(e.self()); }
+
+// element-wise operators: expression op expression, and with a scalar on
+// either side
+#define NUMARRAY_BINARY(op, Op)                                                     \
+template <class L, class R>                                                         \
+numexpr::Binary<L, R, numexpr::Op>                                                  \
+operator op(const numexpr::Expr<L> & a, const numexpr::Expr<R> & b)                 \
+{                                                                                   \
+    return numexpr::Binary<L, R, numexpr::Op>(a.self(), b.self());                  \
+}                                                                                   \
+template <class L>                                                                  \
+numexpr::Binary<L, numexpr::Scalar<typename L::value_type>, numexpr::Op>            \
+operator op(const numexpr::Expr<L> & a, typename L::value_type s)                   \
+{                                                                                   \
+    typedef numexpr::Scalar<typename L::value_type> S;                              \
+    return numexpr::Binary<L, S, numexpr::Op>(a.self(), S(s));                      \
+}                                                                                   \
+template <class R>                                                                  \
+numexpr::Binary<numexpr::Scalar<typename R::value_type>, R, numexpr::Op>            \
+operator op(typename R::value_type s, const numexpr::Expr<R> & b)                   \
+{                                                                                   \
+    typedef numexpr::Scalar<typename R::value_type> S;                              \
+    return numexpr::Binary<S, R, numexpr::Op>(S(s), b.self());                      \
+}
+
+NUMARRAY_BINARY(+, Add)
+NUMARRAY_BINARY(-, Sub)
+NUMARRAY_BINARY(*, Mul)
+NUMARRAY_BINARY(/, Div)
+#undef NUMARRAY_BINARY
+
+#define NUMARRAY_UNARY(name, Op)                                                    \
+template <class A>                                                                  \
+numexpr::Unary<A, numexpr::Op> name(const numexpr::Expr<A> & a)                     \
+{                                                                                   \
+    return numexpr::Unary<A, numexpr::Op>(a.self());                                \
+}
+
+NUMARRAY_UNARY(operator-, Neg)
+NUMARRAY_UNARY(sqrt, Sqrt)
+NUMARRAY_UNARY(abs, Abs)
+NUMARRAY_UNARY(exp, Exp)
+NUMARRAY_UNARY(log, Log)
+NUMARRAY_UNARY(sin, Sin)
+NUMARRAY_UNARY(cos, Cos)
+#undef NUMARRAY_UNARY
+
+#endif
@@ -0,0 +1,150 @@
+// numbench.cpp -- NumArray against std::valarray and plain loops
+// g++ -std=c++14 -O3 -fno-math-errno -pthread numbench.cpp -o numbench
+// usage: numbench [elements] [threads]
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <valarray>
+#include <vector>
+#include "numarray.h"
+
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+using namespace std;
+typedef chrono::steady_clock Clock;
+
+const int REPEAT = 20;
+
+template <class Fn>
+double time_it(Fn fn)
+{
+    fn();                               // warm up
+    Clock::time_point t = Clock::now();
+    for (int r = 0; r < REPEAT; r++)
+        fn();
+    return chrono::duration<double>(Clock::now() - t).count() / REPEAT;
+}
+
+// the valvect.cpp expression, three ways
+NOINLINE void valvect_valarray(valarray<double> & results, const valarray<double> & numbers)
+{
+    results = numbers + 2.0 * sqrt(numbers);
+}
+
+NOINLINE void valvect_numarray(NumArray<double> & results, const NumArray<double> & numbers)
+{
+    results = numbers + 2.0 * sqrt(numbers);
+}
+
+NOINLINE void valvect_loop(double * __restrict results, const double * __restrict numbers, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        results[i] = numbers[i] + 2.0 * sqrt(numbers[i]);
+}
+
+// a longer expression, where valarray's temporaries would hurt most
+NOINLINE void poly_valarray(valarray<double> & r, const valarray<double> & a,
+                            const valarray<double> & b, const valarray<double> & c)
+{
+    r = a * b + c * (a - b) / (c + 1.0) - 0.5 * a;
+}
+
+NOINLINE void poly_numarray(NumArray<double> & r, const NumArray<double> & a,
+                            const NumArray<double> & b, const NumArray<double> & c)
+{
+    r = a * b + c * (a - b) / (c + 1.0) - 0.5 * a;
+}
+
+NOINLINE void poly_loop(double * __restrict r, const double * __restrict a,
+                        const double * __restrict b, const double * __restrict c, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        r[i] = a[i] * b[i] + c[i] * (a[i] - b[i]) / (c[i] + 1.0) - 0.5 * a[i];
+}
+
+// vslice.cpp's "first column = sum of next two" on a tall 3-column matrix;
+// valarray needs the slices copied into valarrays before adding them
+NOINLINE void column_valarray(valarray<double> & m, size_t rows)
+{
+    typedef valarray<double> vd;
+    m[slice(0, rows, 3)] = vd(m[slice(1, rows, 3)]) + vd(m[slice(2, rows, 3)]);
+}
+
+NOINLINE void column_numarray(NumArray<double> & m, size_t rows)
+{
+    m[slice(0, rows, 3)] = m[slice(1, rows, 3)] + m[slice(2, rows, 3)];
+}
+
+NOINLINE void column_loop(double * m, size_t rows)
+{
+    for (size_t i = 0; i < rows; i++)
+        m[3 * i] = m[3 * i + 1] + m[3 * i + 2];
+}
+
+void report(const char * name, double va, double na, double loop, size_t n)
+{
+    cout << name << "\n  valarray " << n / va / 1e6 << " M/s, NumArray "
+         << n / na / 1e6 << " M/s (" << va / na << "x), loop "
+         << n / loop / 1e6 << " M/s\n";
+}
+
+int main(int argc, char * argv[])
+{
+    size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 4000000;
+    if (argc > 2)
+        numexpr::Parallel::threads() = max(1, atoi(argv[2]));
+    n -= n % 3;
+    cout << n << " doubles, " << numexpr::Parallel::threads() << " threads\n";
+
+    valarray<double> va(n), vb(n), vc(n), vr(n);
+    NumArray<double> na(n), nb(n), nc(n), nr(n);
+    vector<double> la(n), lb(n), lc(n), lr(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        va[i] = na[i] = la[i] = 1.0 + i % 1000;
+        vb[i] = nb[i] = lb[i] = 0.5 + i % 37;
+        vc[i] = nc[i] = lc[i] = 2.0 + i % 11;
+    }
+
+    double t1 = time_it([&] { valvect_valarray(vr, va); });
+    double t2 = time_it([&] { valvect_numarray(nr, na); });
+    double t3 = time_it([&] { valvect_loop(lr.data(), la.data(), n); });
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++)
+        err = max(err, fabs(vr[i] - nr[i]) + fabs(lr[i] - nr[i]));
+    report("numbers + 2.0 * sqrt(numbers)", t1, t2, t3, n);
+
+    t1 = time_it([&] { poly_valarray(vr, va, vb, vc); });
+    t2 = time_it([&] { poly_numarray(nr, na, nb, nc); });
+    t3 = time_it([&] { poly_loop(lr.data(), la.data(), lb.data(), lc.data(), n); });
+    for (size_t i = 0; i < n; i++)
+        err = max(err, fabs(vr[i] - nr[i]) + fabs(lr[i] - nr[i]));
+    report("a * b + c * (a - b) / (c + 1.0) - 0.5 * a", t1, t2, t3, n);
+
+    size_t rows = n / 3;
+    t1 = time_it([&] { column_valarray(va, rows); });
+    t2 = time_it([&] { column_numarray(na, rows); });
+    t3 = time_it([&] { column_loop(la.data(), rows); });
+    for (size_t i = 0; i < n; i++)
+        err = max(err, fabs(va[i] - na[i]) + fabs(la[i] - na[i]));
+    report("column slice = slice + slice", t1, t2, t3, rows);
+
+    // gslice: double the top-left quarter of the array seen as a 4-row
+    // matrix; NumArray works on the view, valarray on copies of it
+    size_t cols = n / 4;
+    size_t lens[] = { 4 / 2, cols / 2 };
+    size_t strides[] = { cols, 1 };
+    gslice block(0, valarray<size_t>(lens, 2), valarray<size_t>(strides, 2));
+    va[block] = valarray<double>(va[block]) * valarray<double>(2.0, lens[0] * lens[1]);
+    na[block] = na[block] * 2.0;
+    for (size_t i = 0; i < n; i++)
+        err = max(err, fabs(va[i] - na[i]));
+    cout << "sum " << sum(na * 1.0) << " (valarray " << va.sum() << ")\n";
+    cout << "largest difference from valarray / loops: " << err << endl;
+    return err < 1e-9 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// strfile2.cpp -- strfile.cpp with TokenStream, plus a comparison with getline
+// compile with tokstream.cpp
+// g++ -std=c++17 -O2 strfile2.cpp tokstream.cpp -o strfile2
+// usage: strfile2             lists tobuy.txt as strfile.cpp does
+//        strfile2 -bench [MB]  times both readers on generated files of short
+//                              items and of items longer than a block
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "tokstream.h"
+
+struct Totals
+{
+    unsigned long tokens;
+    unsigned long bytes;
+    unsigned long hash;
+};
+
+Totals with_getline(const char * file)
+{
+    std::ifstream fin(file);
+    std::string item;
+    Totals t = { 0, 0, 0 };
+    while (getline(fin, item, ':'))
+    {
+        t.tokens++;
+        t.bytes += item.size();
+        if (!item.empty())
+            t.hash = t.hash * 31 + (unsigned char) item[0];
+    }
+    return t;
+}
+
+Totals with_tokens(const char * file)
+{
+    std::ifstream fin(file, std::ios_base::binary);
+    TokenStream ts(fin, ':');
+    std::string_view item;
+    Totals t = { 0, 0, 0 };
+    while (ts.next(item))
+    {
+        t.tokens++;
+        t.bytes += item.size();
+        if (!item.empty())
+            t.hash = t.hash * 31 + (unsigned char) item[0];
+    }
+    return t;
+}
+
+// Write about mb MB of ':'-terminated items and time both readers on it.
+// Short items look like tobuy.txt: 3 to 22 characters, with a newline
+// starting every fourth item or so. Long items are 100 to 200 KB, so every
+// one of them crosses TokenStream's 64 KB block.
+bool bench(const char * name, std::size_t mb, bool long_items)
+{
+    using namespace std;
+    const char * file = "tokstream_bench.txt";
+    {
+        ofstream fout(file, ios_base::binary);
+        string item;
+        unsigned long r = 88172645463325252UL, written = 0;
+        while (written < (mb << 20))
+        {
+            r ^= r << 13;
+            r ^= r >> 7;
+            r ^= r << 17;
+            size_t len = long_items ? 100000 + r % 100000 : 3 + r % 20;
+            item.assign(len, char('a' + r % 26));
+            if (r % 4 == 0)
+                item[0] = '\n';
+            fout << item << ':';
+            written += len + 1;
+        }
+    }
+
+    typedef chrono::steady_clock Clock;
+    Clock::time_point t0 = Clock::now();
+    Totals a = with_getline(file);
+    chrono::duration<double> tg = Clock::now() - t0;
+    t0 = Clock::now();
+    Totals b = with_tokens(file);
+    chrono::duration<double> tt = Clock::now() - t0;
+
+    cout << name << ": " << mb << " MB, " << a.tokens << " tokens\n";
+    cout << "  getline:     " << a.tokens / tg.count() / 1e6 << " M tokens/s, "
+         << a.bytes / tg.count() / 1e9 << " GB/s\n";
+    cout << "  TokenStream: " << b.tokens / tt.count() / 1e6 << " M tokens/s, "
+         << b.bytes / tt.count() / 1e9 << " GB/s ("
+         << tg.count() / tt.count() << "x)\n";
+    bool same = a.tokens == b.tokens && a.bytes == b.bytes && a.hash == b.hash;
+    cout << (same ? "  same tokens\n" : "  tokens DIFFER\n");
+    remove(file);
+    return same;
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace std;
+    if (argc < 2 || strcmp(argv[1], "-bench") != 0)
+    {
+        ifstream fin;
+        fin.open("tobuy.txt");
+        if (fin.is_open() == false)
+        {
+            cerr << "Can't open file. Bye.\n";
+            exit(EXIT_FAILURE);
+        }
+        TokenStream ts(fin, ':');
+        string_view item;
+        int count = 0;
+        while (ts.next(item))
+        {
+            ++count;
+            cout << count << ": " << item << endl;
+        }
+        cout << "Done\n";
+        return 0;
+    }
+
+    size_t mb = argc > 2 ? strtoul(argv[2], 0, 10) : 256;
+    bool same = bench("short items", mb, false);
+    same = bench("long items", mb / 4 + 1, true) && same;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+// tokstream.cpp -- TokenStream methods
+#include <cstring>
+#include "tokstream.h"
+
+TokenStream::TokenStream(std::istream & is, char d, std::size_t block)
+    : src(is.rdbuf()), delim(d), buf(block > 0 ? block : 1), pos(0), end(0),
+      eof(false)
+{
+}
+
+// keep the unfinished token, move it to the front and read behind it
+bool TokenStream::refill()
+{
+    if (eof)
+        return false;
+    std::size_t keep = end - pos;
+    if (keep == buf.size())
+        buf.resize(buf.size() * 2);     // one token fills the whole buffer
+    else if (pos > 0)
+        std::memmove(buf.data(), buf.data() + pos, keep);
+    pos = 0;
+    end = keep;
+    std::streamsize got = src ? src->sgetn(buf.data() + end, buf.size() - end) : 0;
+    if (got <= 0)
+    {
+        eof = true;
+        return false;
+    }
+    end += got;
+    return true;
+}
+
+bool TokenStream::next(std::string_view & token)
+{
+    std::size_t scanned = pos;      // no delimiter in [pos, scanned)
+    for (;;)
+    {
+        const char * p = static_cast<const char *>(
+            std::memchr(buf.data() + scanned, delim, end - scanned));
+        if (p)
+        {
+            std::size_t at = p - buf.data();
+            token = std::string_view(buf.data() + pos, at - pos);
+            pos = at + 1;
+            return true;
+        }
+        std::size_t offset = end - pos;
+        if (!refill())
+            break;
+        scanned = offset;           // refill moved the token to the front
+    }
+    // like getline, a last token without a delimiter still counts
+    if (end == pos)
+        return false;
+    token = std::string_view(buf.data() + pos, end - pos);
+    pos = end;
+    return true;
+}
@@ -0,0 +1,36 @@
+// tokstream.h -- streaming delimiter tokenizer (C++17)
+// Does what getline(fin, item, ':') does in strfile.cpp, without a
+// std::string per token. Input is read a block at a time into one buffer,
+// delimiters are found with memchr (vectorized in the C library), and
+// tokens come back as string_views into the buffer. A token that runs past
+// the end of a block is moved to the front and the rest of the block is
+// refilled, so memory stays at one block however large the input is. It
+// grows only if a single token is longer than a block.
+#ifndef TOKSTREAM_H_
+#define TOKSTREAM_H_
+#include <cstddef>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+class TokenStream
+{
+private:
+    std::streambuf * src;
+    char delim;
+    std::vector<char> buf;
+    std::size_t pos;            // start of the next token
+    std::size_t end;            // end of the data in buf
+    bool eof;
+
+    bool refill();              // false when nothing more was read
+public:
+    explicit TokenStream(std::istream & is, char delim = '\n',
+                         std::size_t block = 64 * 1024);
+    // next token, as getline(is, item, delim) would produce it; the view is
+    // valid until the next call. Returns false at the end of the input.
+    bool next(std::string_view & token);
+    std::size_t buffer_size() const { return buf.size(); }
+};
+
+#endif
@@ -0,0 +1,175 @@
+// usewordfreq.cpp -- word frequencies of a big text with WordFreq
+// compile with wordfreq.cpp
+// g++ -std=c++17 -O2 -pthread usewordfreq.cpp wordfreq.cpp -o usewordfreq
+// usage: usewordfreq file [threads]      counts file and shows the top 20
+//        usewordfreq -bench [MB] [threads]
+//            writes a corpus of that size (default 2048 MB) to
+//            wordfreq_corpus.txt and compares with the usealgo.cpp method
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "wordfreq.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point t)
+{
+    return chrono::duration<double>(Clock::now() - t).count();
+}
+
+// usealgo.cpp's word counting, unchanged apart from taking its input
+char toLower(char ch) { return tolower(ch); }
+string & ToLower(string & st)
+{
+    transform(st.begin(), st.end(), st.begin(), toLower);
+    return st;
+}
+
+map<string, int> usealgo_count(vector<string> words)
+{
+    set<string> wordset;
+    transform(words.begin(), words.end(),
+        insert_iterator<set<string> > (wordset, wordset.begin()),
+        ToLower);
+    map<string, int> wordmap;
+    set<string>::iterator si;
+    for (si = wordset.begin(); si != wordset.end(); si++)
+        wordmap[*si] = count(words.begin(), words.end(), *si);
+    return wordmap;
+}
+
+// text with a Zipf-like vocabulary in mixed case
+void write_corpus(const string & name, size_t bytes)
+{
+    const int VOCAB = 50000;
+    vector<string> vocab(VOCAB);
+    unsigned long r = 88172645463325252UL;
+    auto next = [&r] { r ^= r << 13; r ^= r >> 7; r ^= r << 17; return r; };
+    for (int i = 0; i < VOCAB; i++)
+    {
+        int len = 2 + next() % 10;
+        for (int k = 0; k < len; k++)
+            vocab[i] += char((next() % 4 == 0 ? 'A' : 'a') + next() % 26);
+    }
+    // rank ~ 1/x: word index = VOCAB^u - 1 for uniform u
+    ofstream fout(name.c_str(), ios_base::out | ios_base::binary);
+    string line;
+    size_t written = 0;
+    while (written < bytes)
+    {
+        line.clear();
+        for (int w = 0; w < 12; w++)
+        {
+            double u = (next() >> 11) * (1.0 / 9007199254740992.0);
+            line += vocab[size_t(pow(double(VOCAB), u)) - 1];
+            line += w % 5 == 4 ? "\t" : " ";
+        }
+        line += '\n';
+        fout << line;
+        written += line.size();
+    }
+}
+
+void show_top(const WORDFREQ::WordFreq & wf, size_t k)
+{
+    vector<WORDFREQ::WordCount> top = wf.top(k);
+    for (size_t i = 0; i < top.size(); i++)
+        cout << top[i].word << ": " << top[i].count << endl;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " file [threads]\n"
+             << "       " << argv[0] << " -bench [MB] [threads]\n";
+        exit(EXIT_FAILURE);
+    }
+    bool bench = strcmp(argv[1], "-bench") == 0;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    if (argc > (bench ? 3 : 2))
+        threads = max(1, atoi(argv[bench ? 3 : 2]));
+    string file = argv[1];
+
+    if (bench)
+    {
+        size_t mb = argc > 2 ? strtoul(argv[2], 0, 10) : 2048;
+        file = "wordfreq_corpus.txt";
+        cout << "writing " << mb << " MB to " << file << "...\n";
+        write_corpus(file, mb << 20);
+    }
+
+    WORDFREQ::WordFreq wf;
+    Clock::time_point t = Clock::now();
+    try
+    {
+        wf.count_file(file, threads);
+    }
+    catch (exception & e)
+    {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    double secs = seconds_since(t);
+    cout << wf.total() << " words, " << wf.unique() << " different, "
+         << threads << " threads: " << wf.total() / secs / 1e6 << " M words/s\n";
+    show_top(wf, 20);
+    if (!bench)
+        return 0;
+
+    // the usealgo.cpp method is O(different words x words): a small sample
+    ifstream fin(file.c_str());
+    vector<string> sample;
+    string input;
+    const size_t SAMPLE = 100000;
+    while (sample.size() < SAMPLE && fin >> input)
+        sample.push_back(input);
+    t = Clock::now();
+    map<string, int> wordmap = usealgo_count(sample);
+    secs = seconds_since(t);
+    cout << "usealgo.cpp method, " << sample.size() << " words: "
+         << sample.size() / secs / 1e6 << " M words/s\n";
+
+    // a reasonable single-threaded version: cin >> into an unordered_map
+    fin.clear();
+    fin.seekg(0);
+    unordered_map<string, unsigned long> counts;
+    const size_t STREAMED = 20000000;
+    size_t n = 0;
+    t = Clock::now();
+    while (n < STREAMED && fin >> input)
+    {
+        counts[ToLower(input)]++;
+        n++;
+    }
+    secs = seconds_since(t);
+    cout << "ifstream >> and unordered_map, " << n << " words: "
+         << n / secs / 1e6 << " M words/s\n";
+
+    // the sample must give the same counts through WordFreq
+    string text;
+    for (size_t i = 0; i < sample.size(); i++)
+        text += sample[i] + ' ';
+    WORDFREQ::WordFreq check;
+    check.count(text.data(), text.size());
+    vector<WORDFREQ::WordCount> all = check.alphabetical();
+    bool same = all.size() == wordmap.size();
+    map<string, int>::iterator mi = wordmap.begin();
+    for (size_t i = 0; same && i < all.size(); i++, mi++)
+        same = all[i].word == mi->first && all[i].count == (unsigned long) mi->second;
+    cout << (same ? "counts agree with usealgo.cpp\n" : "counts DIFFER from usealgo.cpp\n");
+    remove(file.c_str());
+    return same ? 0 : 1;
+}
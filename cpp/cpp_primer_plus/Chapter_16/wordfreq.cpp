@@ -0,0 +1,343 @@
+// wordfreq.cpp -- WordFreq and CountTable methods
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include "wordfreq.h"
+
+namespace WORDFREQ
+{
+    namespace
+    {
+        inline bool is_space(unsigned char c)
+        {
+            return c == ' ' || unsigned(c - '\t') < 5;     // as isspace() in "C"
+        }
+
+        // bit i set if p[i] is whitespace, for 64 bytes
+        inline std::uint64_t space_mask(const char * p)
+        {
+#if defined(__SSE2__)
+            const __m128i sp = _mm_set1_epi8(' ');
+            const __m128i tab = _mm_set1_epi8('\t');
+            const __m128i four = _mm_set1_epi8(4);
+            std::uint64_t m = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * k));
+                __m128i d = _mm_sub_epi8(v, tab);
+                __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, sp),
+                                          _mm_cmpeq_epi8(_mm_min_epu8(d, four), d));
+                m |= std::uint64_t(unsigned(_mm_movemask_epi8(ws))) << (16 * k);
+            }
+            return m;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            static const std::uint8_t bit[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                                  1, 2, 4, 8, 16, 32, 64, 128 };
+            const uint8x16_t weights = vld1q_u8(bit);
+            const uint8x16_t sp = vdupq_n_u8(' ');
+            const uint8x16_t tab = vdupq_n_u8('\t');
+            const uint8x16_t five = vdupq_n_u8(5);
+            std::uint64_t m = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t *>(p + 16 * k));
+                uint8x16_t ws = vorrq_u8(vceqq_u8(v, sp), vcltq_u8(vsubq_u8(v, tab), five));
+                uint8x16_t b = vandq_u8(ws, weights);
+                std::uint64_t lo = vaddv_u8(vget_low_u8(b));
+                std::uint64_t hi = vaddv_u8(vget_high_u8(b));
+                m |= (lo | hi << 8) << (16 * k);
+            }
+            return m;
+#else
+            std::uint64_t m = 0;
+            for (int k = 0; k < 64; k++)
+                m |= std::uint64_t(is_space(p[k])) << k;
+            return m;
+#endif
+        }
+
+        // count the words of a lowercased block that ends at whitespace
+        // or at the end of the text
+        void count_block(const char * b, std::size_t n, CountTable & table)
+        {
+            std::size_t i = 0, start = 0;
+            bool inword = false;
+            std::uint64_t carry = 1;    // the byte before the block is a boundary
+            for (; i + 64 <= n; i += 64)
+            {
+                std::uint64_t space = space_mask(b + i);
+                std::uint64_t before = (space << 1) | carry;
+                // starts and ends alternate, so walking their union in order
+                // pairs each end with the start before it
+                std::uint64_t events = (~space & before) | (space & ~before);
+                carry = space >> 63;
+                while (events)
+                {
+                    std::size_t pos = i + __builtin_ctzll(events);
+                    events &= events - 1;
+                    if (!inword)
+                        start = pos;
+                    else
+                        table.add(b + start, pos - start, hash_word(b + start, pos - start));
+                    inword = !inword;
+                }
+            }
+            for (; i < n; i++)
+            {
+                bool s = is_space(b[i]);
+                if (!s && !inword)
+                    start = i;
+                else if (s && inword)
+                    table.add(b + start, i - start, hash_word(b + start, i - start));
+                inword = !s;
+            }
+            if (inword)
+                table.add(b + start, n - start, hash_word(b + start, n - start));
+        }
+
+        // move a cut forward to the next whitespace so no word is split
+        std::size_t to_boundary(const char * text, std::size_t pos, std::size_t n)
+        {
+            while (pos < n && !is_space(text[pos]))
+                pos++;
+            return pos;
+        }
+
+        // lowercase and count [text, text + n), 64 KB at a time
+        void count_range(const char * text, std::size_t n, CountTable & table)
+        {
+            const std::size_t BLOCK = 64 * 1024;
+            std::vector<char> buf;
+            for (std::size_t pos = 0; pos < n; )
+            {
+                std::size_t end = to_boundary(text, std::min(pos + BLOCK, n), n);
+                buf.resize(end - pos);
+                fold_lower(text + pos, buf.data(), end - pos);
+                count_block(buf.data(), end - pos, table);
+                pos = end;
+            }
+        }
+
+        bool by_count(const WordCount & a, const WordCount & b)
+        {
+            return a.count != b.count ? a.count > b.count : a.word < b.word;
+        }
+    }
+
+    // plain loop: compilers turn it into SSE2/AVX2/NEON code at -O2/-O3
+    void fold_lower(const char * __restrict src, char * __restrict dst, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            unsigned char c = src[i];
+            dst[i] = char(c | ((unsigned char)(c - 'A') < 26 ? 0x20 : 0));
+        }
+    }
+
+    std::uint64_t hash_word(const char * p, std::size_t n)
+    {
+        const std::uint64_t M = 0x9E3779B97F4A7C15ULL;
+        std::uint64_t h = n * M;
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            std::uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            h = (h ^ w) * M;
+            h ^= h >> 29;
+        }
+        if (i < n)
+        {
+            std::uint64_t w = 0;
+            std::memcpy(&w, p + i, n - i);
+            h = (h ^ w) * M;
+        }
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ULL;
+        return h ^ (h >> 32);
+    }
+
+    // CountTable methods
+
+    CountTable::CountTable(std::size_t capacity)
+        : used(0), words(0), spare(nullptr), spareLen(0)
+    {
+        std::size_t cap = 16;
+        while (cap < capacity)
+            cap *= 2;
+        slots.assign(cap, Entry());
+    }
+
+    const char * CountTable::keep(const char * p, std::size_t n)
+    {
+        const std::size_t BLOCK = 64 * 1024;
+        if (n > spareLen)
+        {
+            std::size_t size = std::max(n, BLOCK);
+            blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+            spare = blocks.back().get();
+            spareLen = size;
+        }
+        std::memcpy(spare, p, n);
+        const char * kept = spare;
+        spare += n;
+        spareLen -= n;
+        return kept;
+    }
+
+    void CountTable::grow()
+    {
+        std::vector<Entry> old(slots.size() * 2, Entry());
+        old.swap(slots);
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t i = 0; i < old.size(); i++)
+        {
+            if (!old[i].word)
+                continue;
+            std::size_t j = old[i].hash & mask;
+            while (slots[j].word)
+                j = (j + 1) & mask;
+            slots[j] = old[i];
+        }
+    }
+
+    void CountTable::add(const char * p, std::size_t n, std::uint64_t h, std::uint64_t k)
+    {
+        words += k;
+        std::size_t mask = slots.size() - 1;
+        std::size_t i = h & mask;
+        for (;; i = (i + 1) & mask)
+        {
+            Entry & e = slots[i];
+            if (!e.word)
+                break;
+            if (e.hash == h && e.len == n && std::memcmp(e.word, p, n) == 0)
+            {
+                e.count += k;
+                return;
+            }
+        }
+        if ((used + 1) * 4 > slots.size() * 3)
+        {
+            grow();
+            mask = slots.size() - 1;
+            for (i = h & mask; slots[i].word; i = (i + 1) & mask)
+                continue;
+        }
+        Entry & e = slots[i];
+        e.hash = h;
+        e.word = keep(p, n);
+        e.len = static_cast<std::uint32_t>(n);
+        e.count = k;
+        used++;
+    }
+
+    void CountTable::merge(const CountTable & other)
+    {
+        for (std::size_t i = 0; i < other.slots.size(); i++)
+        {
+            const Entry & e = other.slots[i];
+            if (e.word)
+                add(e.word, e.len, e.hash, e.count);
+        }
+    }
+
+    std::vector<WordCount> CountTable::entries() const
+    {
+        std::vector<WordCount> v;
+        v.reserve(used);
+        for (std::size_t i = 0; i < slots.size(); i++)
+            if (slots[i].word)
+                v.push_back(WordCount{ std::string_view(slots[i].word, slots[i].len),
+                                       slots[i].count });
+        return v;
+    }
+
+    // WordFreq methods
+
+    void WordFreq::count(const char * text, std::size_t n, unsigned threads)
+    {
+        if (threads <= 1 || n < (std::size_t(1) << 20))
+        {
+            count_range(text, n, table);
+            return;
+        }
+        // several pieces per thread so a slow piece does not hold up the rest
+        std::vector<std::size_t> cut(1, 0);
+        const std::size_t pieces = threads * 4;
+        for (std::size_t k = 1; k < pieces; k++)
+        {
+            std::size_t c = to_boundary(text, std::max(cut.back(), n * k / pieces), n);
+            if (c > cut.back() && c < n)
+                cut.push_back(c);
+        }
+        cut.push_back(n);
+
+        std::vector<CountTable> local(threads);
+        std::atomic<std::size_t> next(0);
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++)
+            pool.push_back(std::thread([&, t] {
+                for (std::size_t k; (k = next.fetch_add(1)) + 1 < cut.size(); )
+                    count_range(text + cut[k], cut[k + 1] - cut[k], local[t]);
+            }));
+        for (unsigned t = 0; t < threads; t++)
+            pool[t].join();
+        for (unsigned t = 0; t < threads; t++)
+            table.merge(local[t]);
+    }
+
+    void WordFreq::count_file(const std::string & path, unsigned threads)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0)
+        {
+            if (fd >= 0)
+                close(fd);
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+        std::size_t n = st.st_size;
+        if (n == 0)
+        {
+            close(fd);
+            return;
+        }
+        void * p = mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+        madvise(p, n, MADV_SEQUENTIAL);
+        count(static_cast<const char *>(p), n, threads);
+        munmap(p, n);           // the table holds copies of the words
+    }
+
+    std::vector<WordCount> WordFreq::top(std::size_t k) const
+    {
+        std::vector<WordCount> v = table.entries();
+        k = std::min(k, v.size());
+        std::partial_sort(v.begin(), v.begin() + k, v.end(), by_count);
+        v.resize(k);
+        return v;
+    }
+
+    std::vector<WordCount> WordFreq::alphabetical() const
+    {
+        std::vector<WordCount> v = table.entries();
+        std::sort(v.begin(), v.end(), [](const WordCount & a, const WordCount & b)
+                  { return a.word < b.word; });
+        return v;
+    }
+}   // end namespace WORDFREQ
@@ -0,0 +1,76 @@
+// wordfreq.h -- word frequencies for large texts (C++17)
+// Words are what usealgo.cpp reads with cin >> input, lowercased as its
+// ToLower() does. Text is lowercased a block at a time, split on a SIMD
+// whitespace mask, and counted into one open-addressing table per thread.
+// The tables are merged at the end. Each distinct word is stored once per
+// table, so memory grows with the vocabulary, not with the text.
+#ifndef WORDFREQ_H_
+#define WORDFREQ_H_
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WORDFREQ
+{
+    struct WordCount
+    {
+        std::string_view word;
+        std::uint64_t count;
+    };
+
+    // ASCII lowercase of n bytes, as tolower() in the "C" locale
+    void fold_lower(const char * src, char * dst, std::size_t n);
+    std::uint64_t hash_word(const char * p, std::size_t n);
+
+    class CountTable
+    {
+    private:
+        struct Entry
+        {
+            std::uint64_t hash;
+            const char * word;          // null: empty slot
+            std::uint32_t len;
+            std::uint64_t count;
+        };
+        std::vector<Entry> slots;       // size is a power of two
+        std::size_t used;
+        std::uint64_t words;
+        // copies of the distinct words
+        std::vector<std::unique_ptr<char[]> > blocks;
+        char * spare;
+        std::size_t spareLen;
+
+        const char * keep(const char * p, std::size_t n);
+        void grow();
+    public:
+        explicit CountTable(std::size_t capacity = 1 << 14);
+        CountTable(CountTable &&) = default;
+        CountTable & operator=(CountTable &&) = default;
+        // p holds n already lowercased bytes, h is hash_word(p, n)
+        void add(const char * p, std::size_t n, std::uint64_t h, std::uint64_t k = 1);
+        void merge(const CountTable & other);
+        std::size_t unique() const { return used; }
+        std::uint64_t total() const { return words; }
+        std::vector<WordCount> entries() const;
+    };
+
+    class WordFreq
+    {
+    private:
+        CountTable table;
+    public:
+        // counts the words of [text, text + n), adding to earlier counts
+        void count(const char * text, std::size_t n, unsigned threads = 1);
+        // maps the file and counts it; throws std::runtime_error
+        void count_file(const std::string & path, unsigned threads = 1);
+        std::uint64_t total() const { return table.total(); }
+        std::size_t unique() const { return table.unique(); }
+        // views stay valid as long as the WordFreq object
+        std::vector<WordCount> top(std::size_t k) const;    // most frequent first
+        std::vector<WordCount> alphabetical() const;
+    };
+}   // end namespace WORDFREQ
+#endif
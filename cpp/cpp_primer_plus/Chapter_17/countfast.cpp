@@ -0,0 +1,371 @@
+// countfast.cpp -- counting lines, words and characters in a list of files
+// Same command line as count.cpp, but files are mapped into memory, split
+// into chunks that are counted on all cores, and each chunk is scanned 16 or
+// 32 bytes at a time with SSE2/AVX2 (x86) or NEON (ARM) compare masks. Words
+// follow GNU wc in the C locale: ' ', '\t', '\n', '\v', '\f', '\r' separate
+// words, a word needs at least one printable byte, and other bytes (controls,
+// bytes >= 0x7f, so all of UTF-8 beyond ASCII) neither start nor end one. The
+// counts agree with LC_ALL=C wc.
+// g++ -std=c++11 -O2 -pthread countfast.cpp -o countfast   (add -mavx2 for AVX2)
+// usage: countfast [-j threads] [-b] filename[s]
+//        -b also times the fin.get(ch) loop of count.cpp for comparison
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+struct Counts
+{
+    std::uint64_t lines;
+    std::uint64_t words;
+    std::uint64_t bytes;
+    Counts() : lines(0), words(0), bytes(0) { }
+    Counts & operator+=(const Counts & c)
+    {
+        lines += c.lines;
+        words += c.words;
+        bytes += c.bytes;
+        return *this;
+    }
+};
+
+inline bool is_space(unsigned char c)
+{
+    return c == ' ' || unsigned(c - '\t') < 5;     // \t \n \v \f \r
+}
+
+inline bool is_graph(unsigned char c)
+{
+    return unsigned(c - '!') < 94;                  // printable, not ' '
+}
+
+inline int popcount64(std::uint64_t x) { return __builtin_popcountll(x); }
+
+// Whether a word is open after [p, p + n), given whether one was open before
+// it: the last space or printable byte decides, other bytes change nothing.
+inline bool ends_in_word(const unsigned char * p, std::size_t n, bool in_word)
+{
+    while (n > 0)
+    {
+        unsigned char c = p[--n];
+        if (is_space(c))
+            return false;
+        if (is_graph(c))
+            return true;
+    }
+    return in_word;
+}
+
+// In-word state after each byte of a group, given the masks of spaces and
+// printable bytes and the state before the group. Printable bytes are in a
+// word; every other byte that is not a space carries the state of the byte
+// below it, so each run of such bytes that starts right after an in-word
+// byte is filled with one add: the carry ripples through the run.
+inline std::uint64_t in_word_mask(std::uint64_t space, std::uint64_t graph,
+                                  std::uint64_t carry, std::uint64_t full)
+{
+    std::uint64_t other = ~(space | graph) & full;
+    std::uint64_t start = ((graph << 1) | carry) & other;
+    return graph | (other & ~(other + start));
+}
+
+// Count [p, p + n). A word starts at every printable byte that is not
+// already in a word, so a chunk only needs to know whether a word is open
+// when it begins.
+Counts count_block(const unsigned char * p, std::size_t n, bool in_word)
+{
+    Counts c;
+    c.bytes = n;
+    std::size_t i = 0;
+    std::uint64_t carry = in_word;      // low bit: a word is open before the group
+#if defined(__AVX2__)
+    const __m256i nl = _mm256_set1_epi8('\n');
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i bang = _mm256_set1_epi8('!');
+    const __m256i last = _mm256_set1_epi8(93);
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        __m256i d = _mm256_sub_epi8(v, tab);
+        __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, sp),
+                                     _mm256_cmpeq_epi8(_mm256_min_epu8(d, four), d));
+        __m256i g = _mm256_sub_epi8(v, bang);
+        g = _mm256_cmpeq_epi8(_mm256_min_epu8(g, last), g);
+        std::uint64_t space = std::uint32_t(_mm256_movemask_epi8(ws));
+        std::uint64_t graph = std::uint32_t(_mm256_movemask_epi8(g));
+        std::uint64_t lf = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+        std::uint64_t word = in_word_mask(space, graph, carry, 0xFFFFFFFFu);
+        c.lines += popcount64(lf);
+        c.words += popcount64(graph & ~((word << 1) | carry));
+        carry = word >> 31;
+    }
+#elif defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    const __m128i bang = _mm_set1_epi8('!');
+    const __m128i last = _mm_set1_epi8(93);
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        __m128i d = _mm_sub_epi8(v, tab);
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, sp),
+                                  _mm_cmpeq_epi8(_mm_min_epu8(d, four), d));
+        __m128i g = _mm_sub_epi8(v, bang);
+        g = _mm_cmpeq_epi8(_mm_min_epu8(g, last), g);
+        std::uint64_t space = unsigned(_mm_movemask_epi8(ws));
+        std::uint64_t graph = unsigned(_mm_movemask_epi8(g));
+        std::uint64_t lf = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+        std::uint64_t word = in_word_mask(space, graph, carry, 0xFFFFu);
+        c.lines += popcount64(lf);
+        c.words += popcount64(graph & ~((word << 1) | carry));
+        carry = word >> 15;
+    }
+#elif defined(__ARM_NEON)
+    // NEON has no movemask; narrowing each 16-bit lane by 4 leaves a 64-bit
+    // mask with 4 bits per byte, which serves the same purpose. The fill in
+    // in_word_mask then starts from the low bit of each nibble only.
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    const uint8x16_t sp = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t five = vdupq_n_u8(5);
+    const uint8x16_t bang = vdupq_n_u8('!');
+    const uint8x16_t count = vdupq_n_u8(94);
+    const std::uint64_t low = 0x1111111111111111ULL;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(p + i);
+        uint8x16_t ws = vorrq_u8(vceqq_u8(v, sp), vcltq_u8(vsubq_u8(v, tab), five));
+        uint8x16_t g = vcltq_u8(vsubq_u8(v, bang), count);
+        uint8x16_t lfv = vceqq_u8(v, nl);
+        std::uint64_t space = vget_lane_u64(vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(ws), 4)), 0);
+        std::uint64_t graph = vget_lane_u64(vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(g), 4)), 0);
+        std::uint64_t lf = vget_lane_u64(vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(lfv), 4)), 0);
+        std::uint64_t other = ~(space | graph);
+        std::uint64_t start = ((graph << 4) | carry) & other & low;
+        std::uint64_t word = graph | (other & ~(other + start));
+        c.lines += popcount64(lf) / 4;
+        c.words += popcount64(graph & ~((word << 4) | (carry ? 0xF : 0))) / 4;
+        carry = word >> 63;
+    }
+#else
+    // portable fallback: same masks, built eight bytes at a time
+    for (; i + 8 <= n; i += 8)
+    {
+        std::uint64_t space = 0, graph = 0, lf = 0;
+        for (int k = 0; k < 8; k++)
+        {
+            space |= std::uint64_t(is_space(p[i + k])) << k;
+            graph |= std::uint64_t(is_graph(p[i + k])) << k;
+            lf += p[i + k] == '\n';
+        }
+        std::uint64_t word = in_word_mask(space, graph, carry, 0xFFu);
+        c.lines += lf;
+        c.words += popcount64(graph & ~((word << 1) | carry));
+        carry = word >> 7;
+    }
+#endif
+    in_word = carry & 1;
+    for (; i < n; i++)
+    {
+        c.lines += p[i] == '\n';
+        if (is_space(p[i]))
+            in_word = false;
+        else if (is_graph(p[i]))
+        {
+            c.words += !in_word;
+            in_word = true;
+        }
+    }
+    return c;
+}
+
+// one piece of one file
+struct Task
+{
+    int file;
+    const unsigned char * data;     // null: file must be read(), not mapped
+    std::size_t len;
+    bool in_word;                   // a word is open where the piece begins
+    Counts result;
+};
+
+struct Input
+{
+    const char * name;
+    int fd;
+    void * map;
+    std::size_t size;
+    bool ok;
+};
+
+// files that cannot be mapped (pipes, /proc files) are read in blocks
+Counts count_fd(int fd)
+{
+    std::vector<unsigned char> buf(1 << 20);
+    Counts c;
+    bool in_word = false;
+    ssize_t got;
+    while ((got = read(fd, buf.data(), buf.size())) > 0)
+    {
+        c += count_block(buf.data(), got, in_word);
+        in_word = ends_in_word(buf.data(), got, in_word);
+    }
+    return c;
+}
+
+// the count.cpp loop, for comparison
+long count_get(const char * name)
+{
+    std::ifstream fin(name);
+    long count = 0;
+    char ch;
+    while (fin.get(ch))
+        count++;
+    return count;
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace std;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    bool baseline = false;
+    int first = 1;
+    while (first < argc && argv[first][0] == '-')
+    {
+        if (strcmp(argv[first], "-j") == 0 && first + 1 < argc)
+        {
+            threads = max(1, atoi(argv[first + 1]));
+            first += 2;
+        }
+        else if (strcmp(argv[first], "-b") == 0)
+        {
+            baseline = true;
+            first++;
+        }
+        else
+            break;
+    }
+    if (first == argc)          // quit if no arguments
+    {
+        cerr << "Usage: " << argv[0] << " [-j threads] [-b] filename[s]\n";
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t CHUNK = size_t(8) << 20;   // big enough to amortize a task
+    auto start = chrono::steady_clock::now();
+    vector<Input> inputs;
+    vector<Task> tasks;
+    for (int file = first; file < argc; file++)
+    {
+        Input in = { argv[file], open(argv[file], O_RDONLY), nullptr, 0, false };
+        struct stat st;
+        if (in.fd < 0 || fstat(in.fd, &st) != 0)
+        {
+            cerr << "Could not open " << argv[file] << endl;
+            inputs.push_back(in);
+            continue;
+        }
+        in.ok = true;
+        int idx = int(inputs.size());
+        if (S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            in.size = st.st_size;
+            in.map = mmap(nullptr, in.size, PROT_READ, MAP_PRIVATE, in.fd, 0);
+            if (in.map == MAP_FAILED)
+                in.map = nullptr;
+        }
+        if (in.map)
+        {
+            madvise(in.map, in.size, MADV_SEQUENTIAL);
+            const unsigned char * p = static_cast<const unsigned char *>(in.map);
+            bool in_word = false;
+            for (size_t off = 0; off < in.size; off += CHUNK)
+            {
+                // usually decided by the last byte of the previous chunk
+                if (off > 0)
+                    in_word = ends_in_word(p + off - CHUNK, CHUNK, in_word);
+                Task t = { idx, p + off, min(CHUNK, in.size - off), in_word, Counts() };
+                tasks.push_back(t);
+            }
+        }
+        else
+        {
+            Task t = { idx, nullptr, 0, false, Counts() };
+            tasks.push_back(t);
+        }
+        inputs.push_back(in);
+    }
+
+    // workers take tasks in order, so neighbouring chunks run together
+    atomic<size_t> next(0);
+    auto work = [&] {
+        for (size_t k; (k = next.fetch_add(1)) < tasks.size(); )
+        {
+            Task & t = tasks[k];
+            t.result = t.data ? count_block(t.data, t.len, t.in_word)
+                              : count_fd(inputs[t.file].fd);
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < min<size_t>(threads, tasks.size()); i++)
+        pool.push_back(thread(work));
+    work();
+    for (size_t i = 0; i < pool.size(); i++)
+        pool[i].join();
+
+    vector<Counts> per(inputs.size());
+    for (size_t k = 0; k < tasks.size(); k++)
+        per[tasks[k].file] += tasks[k].result;
+    Counts total;
+    for (size_t f = 0; f < inputs.size(); f++)
+    {
+        if (!inputs[f].ok)
+            continue;
+        cout << per[f].lines << " lines, " << per[f].words << " words, "
+             << per[f].bytes << " characters in " << inputs[f].name << endl;
+        total += per[f];
+        if (inputs[f].map)
+            munmap(inputs[f].map, inputs[f].size);
+        close(inputs[f].fd);
+    }
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+    cout << total.lines << " lines, " << total.words << " words, "
+         << total.bytes << " characters in all files\n";
+    cerr << threads << " threads: " << total.bytes / secs.count() / 1e9 << " GB/s\n";
+
+    if (baseline)
+    {
+        start = chrono::steady_clock::now();
+        long count = 0;
+        for (size_t f = 0; f < inputs.size(); f++)
+            if (inputs[f].ok)
+                count += count_get(inputs[f].name);
+        secs = chrono::steady_clock::now() - start;
+        cerr << "count.cpp loop: " << count << " characters, "
+             << count / secs.count() / 1e9 << " GB/s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+// planetbench.cpp -- RecordStore against the fstream code of random.cpp
+// compile with planetdb.cpp
+// g++ -std=c++11 -O2 planetbench.cpp planetdb.cpp -o planetbench
+// usage: planetbench [records] [file]
+// The file is created from scratch; it takes records * 40 bytes plus the index
+// while the benchmark runs and is removed, with the index, at the end.
+// RecordStore appends are synced to disk once per batch; ofstream ones are not.
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "planetdb.h"
+using namespace std;
+using PLANETDB::planet;
+using PLANETDB::RecordStore;
+
+typedef chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point t)
+{
+    return chrono::duration<double>(Clock::now() - t).count();
+}
+
+void make_planet(planet & pl, unsigned long i)
+{
+    memset(&pl, 0, sizeof pl);
+    snprintf(pl.name, sizeof pl.name, "Planet-%u", unsigned(i));
+    pl.population = double(i) * 1000.0;
+    pl.g = 9.8 + (i % 100) / 10.0;
+}
+
+unsigned long next_rand(unsigned long & r)
+{
+    r ^= r << 13;
+    r ^= r >> 7;
+    r ^= r << 17;
+    return r;
+}
+
+// as random.cpp finds a record: read from the start until the name matches
+long stream_find(fstream & finout, const char * name)
+{
+    planet pl;
+    long ct = 0;
+    finout.clear();
+    finout.seekg(0);
+    while (finout.read((char *) &pl, sizeof pl))
+    {
+        if (strncmp(pl.name, name, sizeof pl.name) == 0)
+            return ct;
+        ct++;
+    }
+    return -1;
+}
+
+void rate(const char * what, double count, double secs)
+{
+    cout << "  " << what << count / secs << " per second\n";
+}
+
+int main(int argc, char * argv[])
+{
+    unsigned long n = argc > 1 ? strtoul(argv[1], 0, 10) : 10000000;
+    string file = argc > 2 ? argv[2] : "planets_bench.dat";
+    const unsigned long BATCH = 4096;
+    remove(file.c_str());
+    remove((file + ".idx").c_str());
+
+    cout << n << " records in " << file << endl;
+    planet pl;
+    vector<planet> batch(BATCH);
+    {
+        // appends of BATCH records are one group commit each
+        RecordStore store(file, RecordStore::GROUP_COMMIT);
+        Clock::time_point t = Clock::now();
+        for (unsigned long i = 0; i < n; i += BATCH)
+        {
+            unsigned long k = min(BATCH, n - i);
+            for (unsigned long j = 0; j < k; j++)
+                make_planet(batch[j], i + j);
+            store.append(batch.data(), k);
+        }
+        rate("RecordStore appends:    ", n, seconds_since(t));
+    }
+
+    // stream appends as binary.cpp makes them, into a second file
+    string sfile = file + ".stream";
+    {
+        Clock::time_point t = Clock::now();
+        ofstream fout(sfile.c_str(), ios_base::out | ios_base::app | ios_base::binary);
+        for (unsigned long i = 0; i < n; i++)
+        {
+            make_planet(pl, i);
+            fout.write((char *) &pl, sizeof pl);
+        }
+        fout.close();
+        rate("ofstream appends:       ", n, seconds_since(t));
+    }
+    remove(sfile.c_str());
+
+    long errors = 0;
+    {
+        RecordStore store(file);    // reopened: the index comes from disk
+        fstream finout(file.c_str(), ios_base::in | ios_base::out | ios_base::binary);
+        if (!finout.is_open() || store.size() != n)
+        {
+            cerr << file << " could not be reopened -- bye.\n";
+            exit(EXIT_FAILURE);
+        }
+        unsigned long r = 88172645463325252UL;
+        char name[PLANETDB::LIM];
+
+        // lookup by name
+        const unsigned long LOOKUPS = 1000000, SCANS = 5;
+        Clock::time_point t = Clock::now();
+        for (unsigned long i = 0; i < LOOKUPS; i++)
+        {
+            unsigned long k = next_rand(r) % n;
+            snprintf(name, sizeof name, "Planet-%u", unsigned(k));
+            errors += store.find(name) != long(k);
+        }
+        rate("RecordStore lookups:    ", LOOKUPS, seconds_since(t));
+        t = Clock::now();
+        for (unsigned long i = 0; i < SCANS; i++)
+        {
+            unsigned long k = next_rand(r) % n;
+            snprintf(name, sizeof name, "Planet-%u", unsigned(k));
+            errors += stream_find(finout, name) != long(k);
+        }
+        rate("fstream scan lookups:   ", SCANS, seconds_since(t));
+
+        // read and rewrite a record chosen by number, as random.cpp does
+        const unsigned long UPDATES = 1000000;
+        t = Clock::now();
+        for (unsigned long i = 0; i < UPDATES; i++)
+        {
+            unsigned long k = next_rand(r) % n;
+            pl = store[k];
+            pl.population += 1.0;
+            store.update(k, pl);
+        }
+        rate("RecordStore updates:    ", UPDATES, seconds_since(t));
+        t = Clock::now();
+        finout.clear();
+        for (unsigned long i = 0; i < UPDATES; i++)
+        {
+            unsigned long k = next_rand(r) % n;
+            streampos place = k * sizeof pl;
+            finout.seekg(place);
+            finout.read((char *) &pl, sizeof pl);
+            pl.population += 1.0;
+            finout.seekp(place);
+            finout.write((char *) &pl, sizeof pl);
+        }
+        finout.flush();
+        rate("fstream updates:        ", UPDATES, seconds_since(t));
+        finout.close();
+
+        // renames move index entries; the old name must disappear
+        make_planet(pl, n + 1);
+        store.update(0, pl);
+        errors += store.find("Planet-0") != -1;
+        errors += store.find(pl.name) != 0;
+    }
+    // the store is closed; leave nothing behind
+    remove(file.c_str());
+    remove((file + ".idx").c_str());
+
+    cout << (errors ? "lookup errors: " : "all lookups correct") ;
+    if (errors)
+        cout << errors;
+    cout << endl;
+    return errors != 0;
+}
@@ -0,0 +1,287 @@
+// planetdb.cpp -- RecordStore methods
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "planetdb.h"
+
+namespace PLANETDB
+{
+    const char INDEX_MAGIC[8] = { 'P', 'L', 'I', 'D', 'X', '1', 0, 0 };
+
+    struct RecordStore::IndexHeader
+    {
+        char magic[8];
+        std::uint64_t recordSize;   // sizeof(planet) when the index was built
+        std::uint64_t capacity;     // slots
+        std::uint64_t used;         // occupied slots
+        std::uint64_t records;      // data records covered by the index
+        std::uint64_t clean;        // 0 while a RecordStore has it open
+    };
+
+    namespace
+    {
+        void fail(const std::string & what, const std::string & path)
+        {
+            throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        void * map_file(int fd, std::size_t bytes, const std::string & path)
+        {
+            void * p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+                fail("cannot map", path);
+            return p;
+        }
+
+        const std::size_t MIN_SLOTS = 1024;
+    }
+
+    RecordStore::RecordStore(const std::string & path, Sync s)
+        : dataPath(path), indexPath(path + ".idx"), mode(s), dataFd(-1),
+          indexFd(-1), records(nullptr), count(0), mapped(0),
+          header(nullptr), slots(nullptr), capacity(0)
+    {
+        dataFd = open(dataPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (dataFd < 0)
+            fail("cannot open", dataPath);
+        struct stat st;
+        if (fstat(dataFd, &st) != 0)
+            fail("cannot stat", dataPath);
+        // a partial record at the end (an interrupted write) is ignored
+        count = st.st_size / sizeof(planet);
+        map_data(count);
+
+        indexFd = open(indexPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (indexFd < 0)
+            fail("cannot open", indexPath);
+        if (fstat(indexFd, &st) != 0)
+            fail("cannot stat", indexPath);
+        bool usable = false;
+        if (std::size_t(st.st_size) >= sizeof(IndexHeader))
+        {
+            IndexHeader h;
+            if (pread(indexFd, &h, sizeof h, 0) == ssize_t(sizeof h)
+                && std::memcmp(h.magic, INDEX_MAGIC, sizeof h.magic) == 0
+                && h.recordSize == sizeof(planet) && h.records <= count
+                && h.capacity >= MIN_SLOTS && (h.capacity & (h.capacity - 1)) == 0
+                && std::size_t(st.st_size) == sizeof h + h.capacity * sizeof(Slot)
+                && h.clean)
+            {
+                map_index(h.capacity);
+                usable = true;
+            }
+        }
+        // an index left dirty by a crash is rebuilt from the data
+        if (usable)
+            index_from(header->records);    // records appended by other programs
+        else
+            rebuild_index();
+        header->clean = 0;
+    }
+
+    RecordStore::~RecordStore()
+    {
+        // slots reach the disk before the flag that vouches for them
+        if (header)
+        {
+            msync(header, sizeof(IndexHeader) + capacity * sizeof(Slot), MS_SYNC);
+            header->clean = 1;
+            msync(header, sizeof(IndexHeader), MS_SYNC);
+        }
+        if (records)
+            munmap(records, mapped * sizeof(planet));
+        if (header)
+            munmap(header, sizeof(IndexHeader) + capacity * sizeof(Slot));
+        if (dataFd >= 0)
+            close(dataFd);
+        if (indexFd >= 0)
+            close(indexFd);
+    }
+
+    // make the mapping cover at least need records; the mapping may run past
+    // the end of the file, and only the part inside the file is touched
+    void RecordStore::map_data(std::size_t need)
+    {
+        if (records && need <= mapped)
+            return;
+        std::size_t cap = mapped ? mapped : 4096;
+        while (cap < need)
+            cap *= 2;
+        if (records)
+            munmap(records, mapped * sizeof(planet));
+        records = static_cast<planet *>(map_file(dataFd, cap * sizeof(planet), dataPath));
+        mapped = cap;
+    }
+
+    void RecordStore::map_index(std::size_t cap)
+    {
+        if (header)
+            munmap(header, sizeof(IndexHeader) + capacity * sizeof(Slot));
+        std::size_t bytes = sizeof(IndexHeader) + cap * sizeof(Slot);
+        if (ftruncate(indexFd, bytes) != 0)
+            fail("cannot resize", indexPath);
+        header = static_cast<IndexHeader *>(map_file(indexFd, bytes, indexPath));
+        slots = reinterpret_cast<Slot *>(header + 1);
+        capacity = cap;
+    }
+
+    // FNV-1a over the name as stored, stopping at the terminator
+    std::uint32_t RecordStore::hash(const char * name)
+    {
+        std::uint32_t h = 2166136261u;
+        for (int i = 0; i < LIM && name[i]; i++)
+            h = (h ^ static_cast<unsigned char>(name[i])) * 16777619u;
+        return h;
+    }
+
+    bool RecordStore::same_name(const char * a, const char * b)
+    {
+        return std::strncmp(a, b, LIM) == 0;
+    }
+
+    void RecordStore::rebuild_index()
+    {
+        std::size_t cap = MIN_SLOTS;
+        while (cap * 7 < count * 10)
+            cap *= 2;
+        map_index(cap);
+        std::memset(static_cast<void *>(slots), 0, cap * sizeof(Slot));
+        std::memcpy(header->magic, INDEX_MAGIC, sizeof header->magic);
+        header->recordSize = sizeof(planet);
+        header->capacity = cap;
+        header->used = 0;
+        header->records = 0;
+        header->clean = 0;
+        index_from(0);
+    }
+
+    void RecordStore::index_from(std::size_t first)
+    {
+        for (std::size_t r = first; r < count; r++)
+            index_insert(hash(records[r].name), r);
+        header->records = count;
+    }
+
+    // rehash into a table twice the size once it is 70% full
+    void RecordStore::grow_index()
+    {
+        std::size_t old = capacity;
+        Slot * copy = new Slot[old];
+        std::memcpy(copy, slots, old * sizeof(Slot));
+        map_index(old * 2);
+        std::memset(static_cast<void *>(slots), 0, capacity * sizeof(Slot));
+        header->capacity = capacity;
+        header->used = 0;
+        for (std::size_t i = 0; i < old; i++)
+            if (copy[i].rec)
+                index_insert(copy[i].hash, copy[i].rec - 1);
+        delete [] copy;
+    }
+
+    void RecordStore::index_insert(std::uint32_t h, std::size_t rec)
+    {
+        if ((header->used + 1) * 10 > capacity * 7)
+            grow_index();
+        std::size_t mask = capacity - 1;
+        std::size_t i = h & mask;
+        while (slots[i].rec)
+            i = (i + 1) & mask;
+        slots[i].hash = h;
+        slots[i].rec = static_cast<std::uint32_t>(rec + 1);
+        header->used++;
+    }
+
+    // linear probing delete: shift later members of the cluster back so
+    // lookups never stop early at the hole
+    void RecordStore::index_erase(std::size_t rec)
+    {
+        std::size_t mask = capacity - 1;
+        std::size_t i = hash(records[rec].name) & mask;
+        while (slots[i].rec != rec + 1)
+        {
+            if (!slots[i].rec)
+                return;
+            i = (i + 1) & mask;
+        }
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & mask; slots[j].rec; j = (j + 1) & mask)
+        {
+            std::size_t home = slots[j].hash & mask;
+            // move j into the hole unless its home lies in (hole, j]
+            bool stays = hole <= j ? (hole < home && home <= j)
+                                   : (hole < home || home <= j);
+            if (!stays)
+            {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole].hash = 0;
+        slots[hole].rec = 0;
+        header->used--;
+    }
+
+    long RecordStore::find(const char * name) const
+    {
+        std::uint32_t h = hash(name);
+        std::size_t mask = capacity - 1;
+        long best = -1;
+        for (std::size_t i = h & mask; slots[i].rec; i = (i + 1) & mask)
+        {
+            if (slots[i].hash != h)
+                continue;
+            long r = long(slots[i].rec) - 1;
+            if (same_name(records[r].name, name) && (best < 0 || r < best))
+                best = r;
+        }
+        return best;
+    }
+
+    void RecordStore::update(std::size_t rec, const planet & pl)
+    {
+        if (rec >= count)
+            throw std::out_of_range("RecordStore::update: no such record");
+        bool renamed = !same_name(records[rec].name, pl.name);
+        if (renamed)
+            index_erase(rec);
+        records[rec] = pl;
+        if (renamed)
+            index_insert(hash(pl.name), rec);
+    }
+
+    std::size_t RecordStore::append(const planet * pl, std::size_t n)
+    {
+        std::size_t first = count;
+        if (n == 0)
+            return first;
+        if (ftruncate(dataFd, (count + n) * sizeof(planet)) != 0)
+            fail("cannot extend", dataPath);
+        map_data(count + n);
+        std::memcpy(static_cast<void *>(records + count), pl, n * sizeof(planet));
+        if (mode == GROUP_COMMIT)
+        {
+            // data first: the index may lag the data after a crash, never lead
+            long page = sysconf(_SC_PAGESIZE);
+            std::size_t from = first * sizeof(planet) / page * page;
+            std::size_t to = (count + n) * sizeof(planet);
+            if (msync(reinterpret_cast<char *>(records) + from, to - from, MS_SYNC) != 0
+                || fdatasync(dataFd) != 0)
+                fail("cannot sync", dataPath);
+        }
+        count += n;
+        index_from(first);
+        return first;
+    }
+
+    void RecordStore::sync()
+    {
+        if (count && msync(records, count * sizeof(planet), MS_SYNC) != 0)
+            fail("cannot sync", dataPath);
+        if (msync(header, sizeof(IndexHeader) + capacity * sizeof(Slot), MS_SYNC) != 0)
+            fail("cannot sync", indexPath);
+    }
+}   // end namespace PLANETDB
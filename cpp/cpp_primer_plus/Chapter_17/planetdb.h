@@ -0,0 +1,76 @@
+// planetdb.h -- memory-mapped store of planet records with a name index
+// The data file has exactly the layout binary.cpp writes (one planet struct
+// after another, no header), so random.cpp and binary.cpp can still read it.
+// Records are reached through mmap instead of seekg()/read(), and a
+// persistent open-addressing hash index on name lives next to the data in
+// <file>.idx. Appends are batched: one batch is one group commit, the data
+// is synced before the index records it, and an index that lags behind the
+// data is brought up to date on open. POSIX only.
+#ifndef PLANETDB_H_
+#define PLANETDB_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PLANETDB
+{
+    const int LIM = 20;
+    struct planet
+    {
+        char name[LIM];      // name of planet
+        double population;  // its population
+        double g;           // its acceleration of gravity
+    };
+
+    class RecordStore
+    {
+    public:
+        enum Sync
+        {
+            NO_SYNC,            // leave write-back to the kernel
+            GROUP_COMMIT        // msync + fdatasync once per append batch
+        };
+    private:
+        struct IndexHeader;
+        struct Slot { std::uint32_t hash; std::uint32_t rec; };  // rec + 1, 0 = empty
+
+        std::string dataPath;
+        std::string indexPath;
+        Sync mode;
+        int dataFd;
+        int indexFd;
+        planet * records;           // mapping of the data file
+        std::size_t count;          // records in the file
+        std::size_t mapped;         // records the mapping can hold
+        IndexHeader * header;       // mapping of the index file
+        Slot * slots;
+        std::size_t capacity;       // slots, a power of two
+
+        void map_data(std::size_t need);
+        void map_index(std::size_t cap);
+        void grow_index();
+        void index_insert(std::uint32_t h, std::size_t rec);
+        void index_erase(std::size_t rec);
+        void index_from(std::size_t first);
+        static std::uint32_t hash(const char * name);
+        static bool same_name(const char * a, const char * b);
+    public:
+        // opens or creates the data file; throws std::runtime_error
+        explicit RecordStore(const std::string & path, Sync s = GROUP_COMMIT);
+        RecordStore(const RecordStore &) = delete;
+        RecordStore & operator=(const RecordStore &) = delete;
+        ~RecordStore();
+
+        std::size_t size() const { return count; }
+        // O(1) access by record number; valid until the next append()
+        const planet & operator[](std::size_t rec) const { return records[rec]; }
+        // record number of the first planet with this name, or -1
+        long find(const char * name) const;
+        void update(std::size_t rec, const planet & pl);
+        // appends n records as one batch; returns the first record number
+        std::size_t append(const planet * pl, std::size_t n);
+        void sync();                // flush data and index
+        void rebuild_index();       // after the file was edited by other programs
+    };
+}   // end namespace PLANETDB
+#endif
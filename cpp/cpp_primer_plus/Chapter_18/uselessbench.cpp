@@ -0,0 +1,116 @@
+// uselessbench.cpp -- what move semantics save in container workloads
+// g++ -std=c++11 -O2 uselessbench.cpp -o uselessbench
+// usage: uselessbench [objects] [bytes per object]
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "uselessbuf.h"
+using namespace std;
+
+struct Measure
+{
+    UselessStats stats;
+    double ms;
+};
+
+template <class Fn>
+Measure measure(Fn fn)
+{
+    useless_stats().reset();
+    auto start = chrono::steady_clock::now();
+    fn();
+    chrono::duration<double, milli> t = chrono::steady_clock::now() - start;
+    Measure m;
+    m.stats = useless_stats();
+    m.ms = t.count();
+    return m;
+}
+
+// vector<Useless> growth without reserve(): reallocation moves the elements
+// only if the move constructor is noexcept, otherwise it copies them
+template <MovePolicy P>
+void grow(int count, int len)
+{
+    vector<BasicUseless<P> > v;
+    for (int i = 0; i < count; i++)
+        v.push_back(BasicUseless<P>(len, char('a' + i % 26)));
+}
+
+template <MovePolicy P>
+void sort_all(int count, int len)
+{
+    vector<BasicUseless<P> > v;
+    v.reserve(count);
+    srand(1);
+    for (int i = 0; i < count; i++)
+        v.emplace_back(len, char('a' + rand() % 26));
+    sort(v.begin(), v.end());
+}
+
+// emplace into the middle shifts the tail by move assignment
+template <MovePolicy P>
+void emplace_mid(int count, int len)
+{
+    vector<BasicUseless<P> > v;
+    v.reserve(count);
+    for (int i = 0; i < count; i++)
+        v.emplace(v.begin() + v.size() / 2, len, 'x');
+}
+
+// one + two + three + four, as in useless.cpp, over and over
+template <MovePolicy P>
+void concat(int count, int len)
+{
+    BasicUseless<P> one(len, 'x'), two(len, 'o'), three(len, 'x'), four(len, 'o');
+    long total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        BasicUseless<P> sum = one + two + three + four;
+        total += sum.size();
+    }
+    if (total != 4L * len * count)
+        cout << "concat: wrong length\n";
+}
+
+void report(const char * name, const Measure m[3])
+{
+    const char * policy[3] = { "copy only", "move, may throw", "move, noexcept" };
+    cout << name << endl;
+    for (int p = 0; p < 3; p++)
+        cout << "  " << left << setw(17) << policy[p] << right
+             << setw(10) << m[p].stats.allocs << " allocs"
+             << setw(10) << m[p].stats.copies << " copies"
+             << setw(10) << m[p].stats.moves << " moves"
+             << setw(12) << m[p].stats.bytes << " bytes"
+             << setw(10) << fixed << setprecision(2) << m[p].ms << " ms\n";
+    cout << "  avoided by noexcept moves: "
+         << m[0].stats.allocs - m[2].stats.allocs << " allocations, "
+         << m[0].stats.copies - m[2].stats.copies << " copies\n";
+}
+
+#define RUN(name, fn, count, len)                                       \
+    {                                                                   \
+        Measure m[3];                                                   \
+        m[0] = measure([=] { fn<COPY_ONLY>(count, len); });             \
+        m[1] = measure([=] { fn<MOVE_MAY_THROW>(count, len); });        \
+        m[2] = measure([=] { fn<MOVE_NOEXCEPT>(count, len); });         \
+        report(name, m);                                                \
+    }
+
+int main(int argc, char * argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int len = argc > 2 ? atoi(argv[2]) : 64;
+
+    cout << count << " objects of " << len << " bytes\n";
+    RUN("vector growth (push_back, no reserve)", grow, count, len)
+    RUN("sort", sort_all, count, len)
+    RUN("emplace in the middle", emplace_mid, count / 10, len)
+    RUN("one + two + three + four", concat, count, len)
+    if (useless_stats().objects != 0)
+        cout << "leaked objects: " << useless_stats().objects << endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+// uselessbuf.h -- Useless as a quiet, instrumented buffer
+// Instead of printing from every constructor, the class counts allocations,
+// copies and moves in UselessStats so container workloads can be measured.
+// The move policy is a template argument, so the same code also stands in
+// for a copy-only class and for one whose move constructor may throw.
+// Counters are plain integers: use from one thread at a time.
+#ifndef USELESSBUF_H_
+#define USELESSBUF_H_
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+struct UselessStats
+{
+    long objects;       // live objects, as Useless::ct
+    long allocs;        // new [] calls
+    long copies;        // copy constructions and copy assignments
+    long moves;         // move constructions and move assignments
+    long long bytes;    // bytes copied between buffers
+    void reset() { long live = objects; *this = UselessStats(); objects = live; }
+    UselessStats() : objects(0), allocs(0), copies(0), moves(0), bytes(0) { }
+};
+
+inline UselessStats & useless_stats()
+{
+    static UselessStats stats;
+    return stats;
+}
+
+enum MovePolicy
+{
+    COPY_ONLY,          // as a pre-C++11 class: "moves" copy
+    MOVE_MAY_THROW,     // as useless.cpp: move constructor not noexcept
+    MOVE_NOEXCEPT
+};
+
+template <MovePolicy P = MOVE_NOEXCEPT>
+class BasicUseless
+{
+private:
+    int n;          // number of elements
+    int cap;        // size of the buffer pc points to
+    char * pc;      // pointer to data
+    enum { MOVES = P != COPY_ONLY, NOTHROW = P == MOVE_NOEXCEPT };
+
+    static char * allocate(int k)
+    {
+        if (k == 0)
+            return nullptr;
+        useless_stats().allocs++;
+        return new char[k];
+    }
+    void copy_from(const BasicUseless & f)
+    {
+        useless_stats().copies++;
+        useless_stats().bytes += f.n;
+        n = cap = f.n;
+        pc = allocate(n);
+        if (n)
+            std::memcpy(pc, f.pc, n);
+    }
+    void steal(BasicUseless & f)
+    {
+        useless_stats().moves++;
+        n = f.n;
+        cap = f.cap;
+        pc = f.pc;       // steal address
+        f.pc = nullptr;  // give old object nothing in return
+        f.n = f.cap = 0;
+    }
+    // make room for k elements, keeping the current ones
+    void grow(int k)
+    {
+        if (k <= cap)
+            return;
+        int newcap = std::max(k, 2 * cap);
+        char * p = allocate(newcap);
+        if (n)
+            std::memcpy(p, pc, n);
+        useless_stats().bytes += n;
+        delete [] pc;
+        pc = p;
+        cap = newcap;
+    }
+public:
+    BasicUseless() : n(0), cap(0), pc(nullptr) { ++useless_stats().objects; }
+    explicit BasicUseless(int k) : n(k), cap(k), pc(allocate(k))
+    {
+        ++useless_stats().objects;
+    }
+    BasicUseless(int k, char ch) : n(k), cap(k), pc(allocate(k))
+    {
+        ++useless_stats().objects;
+        if (k)
+            std::memset(pc, ch, k);
+    }
+    BasicUseless(const BasicUseless & f)
+    {
+        ++useless_stats().objects;
+        copy_from(f);
+    }
+    BasicUseless(BasicUseless && f) noexcept(NOTHROW)
+    {
+        ++useless_stats().objects;
+        if (MOVES)
+            steal(f);
+        else
+            copy_from(f);
+    }
+    ~BasicUseless()
+    {
+        --useless_stats().objects;
+        delete [] pc;
+    }
+    BasicUseless & operator=(const BasicUseless & f)
+    {
+        if (this == &f)
+            return *this;
+        useless_stats().copies++;
+        useless_stats().bytes += f.n;
+        if (f.n > cap)              // reuse the buffer when it is big enough
+        {
+            delete [] pc;
+            pc = allocate(f.n);
+            cap = f.n;
+        }
+        n = f.n;
+        if (n)
+            std::memcpy(pc, f.pc, n);
+        return *this;
+    }
+    BasicUseless & operator=(BasicUseless && f) noexcept(NOTHROW)
+    {
+        if (this == &f)
+            return *this;
+        if (!MOVES)
+            return *this = static_cast<const BasicUseless &>(f);
+        delete [] pc;
+        steal(f);
+        return *this;
+    }
+
+    // concatenation; an rvalue operand lends its buffer to the result
+    BasicUseless operator+(const BasicUseless & f) const &
+    {
+        BasicUseless temp(n + f.n);
+        if (n)
+            std::memcpy(temp.pc, pc, n);
+        if (f.n)
+            std::memcpy(temp.pc + n, f.pc, f.n);
+        useless_stats().bytes += n + f.n;
+        return temp;
+    }
+    BasicUseless operator+(const BasicUseless & f) &&
+    {
+        if (!MOVES)
+            return static_cast<const BasicUseless &>(*this) + f;
+        int k = f.n;                // f may be *this
+        grow(n + k);
+        if (k)
+            std::memcpy(pc + n, f.pc, k);
+        useless_stats().bytes += k;
+        n += k;
+        return std::move(*this);
+    }
+    BasicUseless operator+(BasicUseless && f) const &
+    {
+        if (!MOVES || this == &f || f.cap < n + f.n)
+            return *this + static_cast<const BasicUseless &>(f);
+        if (f.n)
+            std::memmove(f.pc + n, f.pc, f.n);
+        if (n)
+            std::memcpy(f.pc, pc, n);
+        useless_stats().bytes += n + f.n;
+        f.n += n;
+        return std::move(f);
+    }
+    BasicUseless operator+(BasicUseless && f) &&
+    {
+        return std::move(*this) + static_cast<const BasicUseless &>(f);
+    }
+
+    friend bool operator<(const BasicUseless & a, const BasicUseless & b)
+    {
+        return std::lexicographical_compare(a.pc, a.pc + a.n, b.pc, b.pc + b.n);
+    }
+    int size() const { return n; }
+    int capacity() const { return cap; }
+    const char * data() const { return pc; }
+    void ShowObject() const
+    {
+        std::cout << "Number of elements: " << n;
+        std::cout << " Data address: " << (void *) pc << std::endl;
+    }
+    void ShowData() const
+    {
+        if (n == 0)
+            std::cout << "(object empty)";
+        else
+            for (int i = 0; i < n; i++)
+                std::cout << pc[i];
+        std::cout << std::endl;
+    }
+};
+
+typedef BasicUseless<MOVE_NOEXCEPT> Useless;
+
+#endif
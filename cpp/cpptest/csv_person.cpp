@@ -0,0 +1,293 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// Fast CSV input/output for the Person records of file_stream.cpp (C++17).
+// The rows use the same format as Person's operator<< and operator>>:
+//     name,age,salary      (salary with two decimals, name without commas)
+// but are parsed straight out of one big buffer with std::from_chars and
+// written with std::to_chars, into and out of a column-oriented table.
+
+// Structure for demonstration, as in file_stream.cpp
+struct Person {
+    std::string name;
+    int age;
+    double salary;
+
+    Person(const std::string& n = "", int a = 0, double s = 0.0)
+        : name(n), age(a), salary(s) {}
+};
+
+std::ostream& operator<<(std::ostream& os, const Person& p) {
+    os << p.name << "," << p.age << "," << std::fixed << std::setprecision(2) << p.salary;
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, Person& p) {
+    std::string line;
+    if (std::getline(is, line)) {
+        std::stringstream ss(line);
+        std::string age_str, salary_str;
+
+        std::getline(ss, p.name, ',');
+        std::getline(ss, age_str, ',');
+        std::getline(ss, salary_str);
+
+        p.age = std::stoi(age_str);
+        p.salary = std::stod(salary_str);
+    }
+    return is;
+}
+
+// Column-oriented storage: all names back to back in one string,
+// ages and salaries in their own arrays
+class PersonTable {
+public:
+    std::size_t size() const { return ages_.size(); }
+
+    std::string_view name(std::size_t i) const {
+        return std::string_view(names_.data() + nameStart_[i],
+                                nameStart_[i + 1] - nameStart_[i]);
+    }
+    int age(std::size_t i) const { return ages_[i]; }
+    double salary(std::size_t i) const { return salaries_[i]; }
+    const std::vector<int>& ages() const { return ages_; }
+    const std::vector<double>& salaries() const { return salaries_; }
+
+    void reserve(std::size_t rows, std::size_t nameBytes) {
+        names_.reserve(nameBytes);
+        nameStart_.reserve(rows + 1);
+        ages_.reserve(rows);
+        salaries_.reserve(rows);
+    }
+
+    void push_back(std::string_view name, int age, double salary) {
+        names_.append(name.data(), name.size());
+        nameStart_.push_back(names_.size());
+        ages_.push_back(age);
+        salaries_.push_back(salary);
+    }
+
+    Person row(std::size_t i) const {
+        return Person(std::string(name(i)), ages_[i], salaries_[i]);
+    }
+
+private:
+    std::string names_;
+    std::vector<std::size_t> nameStart_{0};   // size() + 1 offsets into names_
+    std::vector<int> ages_;
+    std::vector<double> salaries_;
+};
+
+// Parse every row of text into table; blank lines are skipped.
+// Throws std::runtime_error naming the line of a malformed row.
+std::size_t parse_csv(std::string_view text, PersonTable& table) {
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    std::size_t rows = 0, line = 0;
+
+    auto bad = [&line](const char* what) {
+        throw std::runtime_error("line " + std::to_string(line) + ": " + what);
+    };
+
+    while (p < end) {
+        ++line;
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        const char* last = eol;
+        if (last > p && last[-1] == '\r')
+            --last;
+        if (last == p) {
+            p = eol + 1;
+            continue;
+        }
+
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', last - p));
+        if (!comma)
+            bad("missing ','");
+        std::string_view name(p, comma - p);
+
+        int age = 0;
+        auto r1 = std::from_chars(comma + 1, last, age);
+        if (r1.ec != std::errc() || r1.ptr == last || *r1.ptr != ',')
+            bad("bad age");
+
+        double salary = 0.0;
+        auto r2 = std::from_chars(r1.ptr + 1, last, salary);
+        if (r2.ec != std::errc() || r2.ptr != last)
+            bad("bad salary");
+
+        table.push_back(name, age, salary);
+        ++rows;
+        p = eol + 1;
+    }
+    return rows;
+}
+
+// Read a whole file in one go and parse it
+std::size_t read_csv(const std::string& path, PersonTable& table) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+    in.seekg(0, std::ios::end);
+    std::string buffer(static_cast<std::size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    in.read(&buffer[0], buffer.size());
+    // rows are at least 6 bytes ("a,1,2\n"); reserve for about 24 each
+    table.reserve(table.size() + buffer.size() / 24, buffer.size() / 2);
+    return parse_csv(buffer, table);
+}
+
+// Write x with two decimals as std::fixed / setprecision(2) would.
+// Most values are printed as whole cents, which is much cheaper than
+// floating-point to_chars; values that sit too near a rounding tie
+// (or are negative or huge) take the exact to_chars path.
+char* put_money(char* first, char* last, double x) {
+    double c = x * 100.0;
+    if (c >= 0.0 && c < 1e15) {
+        double whole = std::floor(c);
+        double frac = c - whole;
+        if (std::fabs(frac - 0.5) > 1e-6) {
+            long long cents = static_cast<long long>(whole) + (frac > 0.5);
+            first = std::to_chars(first, last, cents / 100).ptr;
+            *first++ = '.';
+            *first++ = char('0' + cents % 100 / 10);
+            *first++ = char('0' + cents % 10);
+            return first;
+        }
+    }
+    return std::to_chars(first, last, x, std::chars_format::fixed, 2).ptr;
+}
+
+// Append rows to out exactly as operator<< writes them, one per line
+void format_csv(const PersonTable& table, std::string& out) {
+    char num[400];      // room for any double in fixed notation
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        std::string_view name = table.name(i);
+        out.append(name.data(), name.size());
+        char* p = num;
+        *p++ = ',';
+        p = std::to_chars(p, num + sizeof num, table.age(i)).ptr;
+        *p++ = ',';
+        p = put_money(p, num + sizeof num - 1, table.salary(i));
+        *p++ = '\n';
+        out.append(num, p);
+    }
+}
+
+void write_csv(const std::string& path, const PersonTable& table) {
+    std::string out;
+    out.reserve(table.size() * 24);
+    format_csv(table, out);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(out.data(), out.size()))
+        throw std::runtime_error("cannot write " + path);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== Fast CSV Person I/O ===" << std::endl;
+    const std::size_t rows = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    // 1. Build some people
+    std::cout << "\n1. Generating " << rows << " people" << std::endl;
+    const char* names[] = {"Alice", "Bob", "Charlie", "Dorothy", "Evangeline"};
+    std::vector<Person> people;
+    PersonTable table;
+    table.reserve(rows, rows * 8);
+    std::uint32_t seed = 12345;
+    for (std::size_t i = 0; i < rows; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        std::string name = names[i % 5] + std::to_string(i);
+        int age = 18 + seed % 50;
+        double salary = 30000 + (seed >> 8) % 9000000 / 100.0;
+        people.emplace_back(name, age, salary);
+        table.push_back(name, age, salary);
+    }
+
+    // 2. Stream version: operator<< and operator>>
+    std::cout << "\n2. iostream operators:" << std::endl;
+    auto t = std::chrono::steady_clock::now();
+    {
+        std::ofstream out("people_stream.csv");
+        for (const auto& person : people)
+            out << person << std::endl;
+    }
+    double streamWrite = seconds_since(t);
+
+    t = std::chrono::steady_clock::now();
+    std::vector<Person> readPeople;
+    {
+        std::ifstream in("people_stream.csv");
+        Person p;
+        while (in >> p)
+            readPeople.push_back(p);
+    }
+    double streamRead = seconds_since(t);
+    std::cout << "write: " << rows / streamWrite / 1e6 << " M rows/s" << std::endl;
+    std::cout << "read:  " << rows / streamRead / 1e6 << " M rows/s" << std::endl;
+
+    // 3. Bulk version: to_chars / from_chars into PersonTable
+    std::cout << "\n3. PersonTable with to_chars/from_chars:" << std::endl;
+    t = std::chrono::steady_clock::now();
+    write_csv("people_fast.csv", table);
+    double fastWrite = seconds_since(t);
+
+    PersonTable loaded;
+    t = std::chrono::steady_clock::now();
+    try {
+        read_csv("people_fast.csv", loaded);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    double fastRead = seconds_since(t);
+    std::cout << "write: " << rows / fastWrite / 1e6 << " M rows/s ("
+              << streamWrite / fastWrite << "x)" << std::endl;
+    std::cout << "read:  " << rows / fastRead / 1e6 << " M rows/s ("
+              << streamRead / fastRead << "x)" << std::endl;
+
+    // 4. Both writers produce the same file, and both readers the same rows
+    std::cout << "\n4. Checking:" << std::endl;
+    std::ifstream a("people_stream.csv"), b("people_fast.csv");
+    std::stringstream sa, sb;
+    sa << a.rdbuf();
+    sb << b.rdbuf();
+    bool sameFile = sa.str() == sb.str();
+    bool sameRows = loaded.size() == readPeople.size();
+    for (std::size_t i = 0; sameRows && i < loaded.size(); ++i)
+        sameRows = loaded.name(i) == readPeople[i].name
+                && loaded.age(i) == readPeople[i].age
+                && loaded.salary(i) == readPeople[i].salary;
+    std::cout << "files identical: " << std::boolalpha << sameFile << std::endl;
+    std::cout << "rows identical:  " << sameRows << std::endl;
+    std::cout << "first row: " << loaded.row(0) << std::endl;
+
+    // 5. Malformed input is reported with its line number
+    std::cout << "\n5. Error handling:" << std::endl;
+    PersonTable scratch;
+    try {
+        parse_csv("Alice,30,50000.00\nBob,twenty,45000.00\n", scratch);
+    } catch (const std::runtime_error& e) {
+        std::cout << "Caught: " << e.what() << std::endl;
+    }
+
+    std::remove("people_stream.csv");
+    std::remove("people_fast.csv");
+    return sameFile && sameRows ? 0 : 1;
+}
@@ -0,0 +1,560 @@
+// adaptive_sort.cpp
+// 自适应策略：先对输入抽样（规模、有序度、重复率、取值范围），再选择具体的排序算法。
+// 选择阈值由本机上运行的校准基准测得，保存在 sort_thresholds.txt 中。
+// g++ -std=c++17 -O2 -pthread adaptive_sort.cpp -o adaptive_sort
+// ./adaptive_sort              # 没有阈值文件时先校准
+// ./adaptive_sort --calibrate  # 强制重新校准
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 策略接口
+class SortStrategy {
+public:
+    virtual void sort(std::vector<int>& data) = 0;
+    virtual ~SortStrategy() = default;
+};
+
+// 上下文类
+class Sorter {
+    std::unique_ptr<SortStrategy> strategy;
+
+public:
+    void setStrategy(std::unique_ptr<SortStrategy> newStrategy) {
+        strategy = std::move(newStrategy);
+    }
+
+    void executeSort(std::vector<int>& data) {
+        strategy->sort(data);
+    }
+};
+
+namespace kernels {
+
+const std::ptrdiff_t SmallSort = 24;
+
+void insertionSort(int* first, int* last) {
+    if (first == last) return;
+    for (int* cur = first + 1; cur != last; ++cur) {
+        int v = *cur;
+        int* sift = cur;
+        while (sift != first && v < *(sift - 1)) {
+            *sift = *(sift - 1);
+            --sift;
+        }
+        *sift = v;
+    }
+}
+
+// 最多搬动 limit 次，超出就放弃；用于“看起来已经有序”的分区
+bool partialInsertionSort(int* first, int* last, int limit = 8) {
+    if (first == last) return true;
+    int moves = 0;
+    for (int* cur = first + 1; cur != last; ++cur) {
+        int v = *cur;
+        int* sift = cur;
+        while (sift != first && v < *(sift - 1)) {
+            *sift = *(sift - 1);
+            --sift;
+        }
+        *sift = v;
+        moves += static_cast<int>(cur - sift);
+        if (moves > limit) return false;
+    }
+    return true;
+}
+
+void sort3(int* a, int* b, int* c) {
+    if (*b < *a) std::swap(*a, *b);
+    if (*c < *b) std::swap(*b, *c);
+    if (*b < *a) std::swap(*a, *b);
+}
+
+// 分区后 [first, p) < pivot，(p, last) >= pivot
+int* partitionRight(int* first, int* last, bool& alreadyPartitioned) {
+    int pivot = *first;
+    int* i = first + 1;
+    int* j = last - 1;
+    alreadyPartitioned = true;
+    for (;;) {
+        while (i <= j && *i < pivot) ++i;
+        while (i <= j && !(*j < pivot)) --j;
+        if (i >= j) break;
+        std::swap(*i++, *j--);
+        alreadyPartitioned = false;
+    }
+    int* p = i - 1;
+    std::swap(*first, *p);
+    return p;
+}
+
+// 与 pivot 相等的元素全部放到左边；调用方据此一次跳过整段重复值
+int* partitionLeft(int* first, int* last) {
+    int pivot = *first;
+    int* i = first + 1;
+    int* j = last - 1;
+    for (;;) {
+        while (i <= j && !(pivot < *i)) ++i;
+        while (i <= j && pivot < *j) --j;
+        if (i >= j) break;
+        std::swap(*i++, *j--);
+    }
+    int* p = i - 1;
+    std::swap(*first, *p);
+    return p;
+}
+
+// pdqsort 风格的内省排序：三数/九数取中、重复值快速通道、
+// 对已分好的区间尝试有限插入排序、递归过深时退化为堆排序
+void introSortLoop(int* first, int* last, int depth, bool leftmost) {
+    for (;;) {
+        std::ptrdiff_t n = last - first;
+        if (n < SmallSort) {
+            insertionSort(first, last);
+            return;
+        }
+
+        int* mid = first + n / 2;
+        if (n > 128) {
+            sort3(first, mid, last - 1);
+            sort3(first + 1, mid - 1, last - 2);
+            sort3(first + 2, mid + 1, last - 3);
+            sort3(mid - 1, mid, mid + 1);
+        } else {
+            sort3(mid, first, last - 1);
+        }
+        std::swap(*first, *mid);
+
+        if (!leftmost && !(*(first - 1) < *first)) {
+            first = partitionLeft(first, last) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned = false;
+        int* p = partitionRight(first, last, alreadyPartitioned);
+
+        if (depth-- == 0) {
+            std::make_heap(first, last);
+            std::sort_heap(first, last);
+            return;
+        }
+
+        if (alreadyPartitioned && partialInsertionSort(first, p) &&
+            partialInsertionSort(p + 1, last)) {
+            return;
+        }
+
+        introSortLoop(first, p, depth, leftmost);
+        first = p + 1;
+        leftmost = false;
+    }
+}
+
+void introSort(int* first, int* last) {
+    std::ptrdiff_t n = last - first;
+    int depth = 0;
+    while (n > 1) {
+        n >>= 1;
+        ++depth;
+    }
+    introSortLoop(first, last, 2 * depth, true);
+}
+
+void countingSort(std::vector<int>& data, int lo, int hi) {
+    std::vector<std::size_t> counts(static_cast<std::size_t>(
+        static_cast<std::int64_t>(hi) - lo + 1));
+    for (int v : data) ++counts[static_cast<std::size_t>(static_cast<std::int64_t>(v) - lo)];
+    std::size_t k = 0;
+    for (std::size_t b = 0; b < counts.size(); ++b) {
+        int v = static_cast<int>(lo + static_cast<std::int64_t>(b));
+        for (std::size_t c = counts[b]; c > 0; --c) data[k++] = v;
+    }
+}
+
+// LSD 基数排序，每趟 8 位；某一字节全相同的趟直接跳过
+void radixSort(std::vector<int>& data) {
+    const std::size_t n = data.size();
+    std::vector<std::uint32_t> a(n), b(n);
+    for (std::size_t i = 0; i < n; ++i) a[i] = static_cast<std::uint32_t>(data[i]) ^ 0x80000000u;
+
+    std::size_t hist[4][256] = {};
+    for (std::uint32_t k : a) {
+        ++hist[0][k & 0xff];
+        ++hist[1][(k >> 8) & 0xff];
+        ++hist[2][(k >> 16) & 0xff];
+        ++hist[3][k >> 24];
+    }
+    for (int pass = 0; pass < 4; ++pass) {
+        std::size_t* h = hist[pass];
+        int shift = pass * 8;
+        if (h[(a[0] >> shift) & 0xff] == n) continue;
+        std::size_t sum = 0;
+        for (int d = 0; d < 256; ++d) {
+            std::size_t c = h[d];
+            h[d] = sum;
+            sum += c;
+        }
+        for (std::uint32_t k : a) b[h[(k >> shift) & 0xff]++] = k;
+        a.swap(b);
+    }
+    for (std::size_t i = 0; i < n; ++i) data[i] = static_cast<int>(a[i] ^ 0x80000000u);
+}
+
+// 分块并行内省排序，再逐轮两两归并
+void parallelSort(std::vector<int>& data, unsigned threads) {
+    const std::size_t n = data.size();
+    std::vector<std::size_t> cuts;
+    for (unsigned t = 0; t <= threads; ++t) cuts.push_back(n * t / threads);
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&data, &cuts, t] {
+            introSort(data.data() + cuts[t], data.data() + cuts[t + 1]);
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    for (std::size_t width = 1; width < threads; width *= 2) {
+        workers.clear();
+        for (std::size_t t = 0; t + width < threads; t += 2 * width) {
+            std::size_t lo = cuts[t];
+            std::size_t mid = cuts[t + width];
+            std::size_t hi = cuts[std::min<std::size_t>(t + 2 * width, threads)];
+            workers.emplace_back([&data, lo, mid, hi] {
+                std::inplace_merge(data.begin() + lo, data.begin() + mid, data.begin() + hi);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+}
+
+} // namespace kernels
+
+// 选择阈值；默认值只是兜底，实际值来自 calibrate()
+struct SortThresholds {
+    std::size_t insertionMax = 32;        // 不超过此规模用插入排序
+    double countingRangeFactor = 2.0;     // 取值范围 <= factor * n 时用计数排序
+    std::size_t radixMin = 1 << 16;       // 至少这么多元素才考虑基数排序
+    double radixMaxDuplicates = 0.5;      // 重复率高于此值时内省排序更划算
+    std::size_t parallelMin = std::numeric_limits<std::size_t>::max();
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        out << insertionMax << ' ' << countingRangeFactor << ' ' << radixMin << ' '
+            << radixMaxDuplicates << ' ' << parallelMin << '\n';
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        SortThresholds t;
+        if (!(in >> t.insertionMax >> t.countingRangeFactor >> t.radixMin >>
+              t.radixMaxDuplicates >> t.parallelMin)) {
+            return false;
+        }
+        *this = t;
+        return true;
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const SortThresholds& t) {
+    os << "insertion <= " << t.insertionMax << ", counting when range <= "
+       << t.countingRangeFactor << " * n, radix from " << t.radixMin
+       << " (dup < " << t.radixMaxDuplicates << "), parallel from ";
+    if (t.parallelMin == std::numeric_limits<std::size_t>::max())
+        os << "never";
+    else
+        os << t.parallelMin;
+    return os;
+}
+
+// 对输入的抽样画像
+struct InputProfile {
+    std::size_t size = 0;
+    double ascending = 0;   // 抽样相邻对中非降序的比例
+    double descending = 0;  // 抽样相邻对中非升序的比例
+    double duplicates = 0;  // 抽样值中重复值的比例
+    int minValue = 0;
+    int maxValue = 0;
+
+    static InputProfile of(const std::vector<int>& data) {
+        InputProfile p;
+        p.size = data.size();
+        if (data.size() < 2) return p;
+
+        const std::size_t pairs = std::min<std::size_t>(64, data.size() - 1);
+        const std::size_t stride = (data.size() - 1) / pairs;
+        std::size_t up = 0, down = 0;
+        std::vector<int> sample;
+        sample.reserve(2 * pairs);
+        for (std::size_t k = 0; k < pairs; ++k) {
+            std::size_t i = k * stride;
+            up += data[i] <= data[i + 1];
+            down += data[i] >= data[i + 1];
+            sample.push_back(data[i]);
+            sample.push_back(data[i + (stride + 1) / 2]);
+        }
+        p.ascending = static_cast<double>(up) / pairs;
+        p.descending = static_cast<double>(down) / pairs;
+
+        std::sort(sample.begin(), sample.end());
+        std::size_t unique = std::unique(sample.begin(), sample.end()) - sample.begin();
+        p.duplicates = 1.0 - static_cast<double>(unique) / sample.size();
+
+        auto mm = std::minmax_element(data.begin(), data.end());
+        p.minValue = *mm.first;
+        p.maxValue = *mm.second;
+        return p;
+    }
+
+    double range() const {
+        return static_cast<double>(maxValue) - static_cast<double>(minValue) + 1.0;
+    }
+};
+
+class AdaptiveSort : public SortStrategy {
+public:
+    enum class Choice { Trivial, Insertion, Presorted, Reversed, Counting, Radix, Parallel, Intro };
+
+    explicit AdaptiveSort(SortThresholds t = SortThresholds()) : t_(t) {}
+
+    void sort(std::vector<int>& data) override {
+        last_ = choose(data);
+        switch (last_) {
+        case Choice::Trivial:
+        case Choice::Presorted:
+            break;
+        case Choice::Reversed:
+            std::reverse(data.begin(), data.end());
+            break;
+        case Choice::Insertion:
+            kernels::insertionSort(data.data(), data.data() + data.size());
+            break;
+        case Choice::Counting:
+            kernels::countingSort(data, profile_.minValue, profile_.maxValue);
+            break;
+        case Choice::Radix:
+            kernels::radixSort(data);
+            break;
+        case Choice::Parallel:
+            kernels::parallelSort(data, threads());
+            break;
+        case Choice::Intro:
+            kernels::introSort(data.data(), data.data() + data.size());
+            break;
+        }
+    }
+
+    Choice lastChoice() const { return last_; }
+    const InputProfile& lastProfile() const { return profile_; }
+
+    static const char* name(Choice c) {
+        switch (c) {
+        case Choice::Trivial: return "trivial";
+        case Choice::Insertion: return "insertion";
+        case Choice::Presorted: return "already sorted";
+        case Choice::Reversed: return "reverse";
+        case Choice::Counting: return "counting";
+        case Choice::Radix: return "radix";
+        case Choice::Parallel: return "parallel";
+        case Choice::Intro: return "introsort";
+        }
+        return "?";
+    }
+
+    static unsigned threads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+private:
+    Choice choose(const std::vector<int>& data) {
+        const std::size_t n = data.size();
+        profile_ = InputProfile();
+        profile_.size = n;
+        if (n < 2) return Choice::Trivial;
+        if (n <= t_.insertionMax) return Choice::Insertion;
+
+        profile_ = InputProfile::of(data);
+        // 抽样看起来有序时再做一次完整的线性检查
+        if (profile_.ascending == 1.0 && std::is_sorted(data.begin(), data.end()))
+            return Choice::Presorted;
+        if (profile_.descending == 1.0 &&
+            std::is_sorted(data.rbegin(), data.rend()) &&
+            std::adjacent_find(data.begin(), data.end()) == data.end())
+            return Choice::Reversed;   // 严格降序才能直接翻转，保证结果一致
+
+        if (profile_.range() <= t_.countingRangeFactor * static_cast<double>(n))
+            return Choice::Counting;
+        if (n >= t_.parallelMin && threads() > 1) return Choice::Parallel;
+        if (n >= t_.radixMin && profile_.duplicates < t_.radixMaxDuplicates &&
+            profile_.ascending < 0.9 && profile_.descending < 0.9)
+            return Choice::Radix;
+        return Choice::Intro;
+    }
+
+    SortThresholds t_;
+    InputProfile profile_;
+    Choice last_ = Choice::Trivial;
+};
+
+// ---- 校准基准 ----
+
+template <typename Fn>
+double bestOf(int reps, const std::vector<int>& input, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    std::vector<int> work;
+    for (int r = 0; r < reps; ++r) {
+        work = input;
+        auto start = std::chrono::steady_clock::now();
+        fn(work);
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        best = std::min(best, d.count());
+    }
+    return best;
+}
+
+std::vector<int> randomInts(std::size_t n, int lo, int hi, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(lo, hi);
+    std::vector<int> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+void introSortVec(std::vector<int>& v) { kernels::introSort(v.data(), v.data() + v.size()); }
+
+SortThresholds calibrate() {
+    SortThresholds t;
+
+    // 插入排序：小规模时逐个比较，取最后一个不慢于内省排序的规模
+    t.insertionMax = 8;
+    for (std::size_t n = 8; n <= 128; n += 8) {
+        // 小数组单次太快，一次测一批
+        auto batch = randomInts(n * 256, 0, 1 << 30, static_cast<unsigned>(n));
+        auto each = [n](void (*f)(int*, int*)) {
+            return [n, f](std::vector<int>& v) {
+                for (std::size_t off = 0; off < v.size(); off += n) f(v.data() + off, v.data() + off + n);
+            };
+        };
+        double ins = bestOf(5, batch, each(kernels::insertionSort));
+        double intro = bestOf(5, batch, each(kernels::introSort));
+        if (ins <= intro) t.insertionMax = n;
+    }
+
+    // 计数排序：固定 n，逐步放宽取值范围
+    const std::size_t cn = 1 << 18;
+    t.countingRangeFactor = 0;
+    for (double factor : {1.0 / 16, 1.0 / 4, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0}) {
+        int hi = static_cast<int>(factor * cn);
+        auto v = randomInts(cn, 0, hi, 7);
+        double cnt = bestOf(3, v, [hi](std::vector<int>& w) { kernels::countingSort(w, 0, hi); });
+        double intro = bestOf(3, v, introSortVec);
+        if (cnt <= intro) t.countingRangeFactor = factor;
+    }
+
+    // 基数排序：随机全范围键
+    t.radixMin = std::numeric_limits<std::size_t>::max();
+    for (std::size_t n = 1 << 10; n <= (1 << 20); n <<= 1) {
+        auto v = randomInts(n, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 11);
+        double radix = bestOf(3, v, kernels::radixSort);
+        double intro = bestOf(3, v, introSortVec);
+        if (radix < intro) {
+            t.radixMin = n;
+            break;
+        }
+    }
+
+    // 基数排序在重复值多时的临界点
+    t.radixMaxDuplicates = 0;
+    const std::size_t rn = std::max<std::size_t>(t.radixMin == std::numeric_limits<std::size_t>::max()
+                                                     ? 1 << 18 : t.radixMin, 1 << 16);
+    for (double dup : {0.0, 0.25, 0.5, 0.75, 0.9}) {
+        int distinct = std::max(1, static_cast<int>(rn * (1.0 - dup)));
+        auto keys = randomInts(static_cast<std::size_t>(distinct), std::numeric_limits<int>::min(),
+                               std::numeric_limits<int>::max(), 13);
+        std::vector<int> v(rn);
+        std::mt19937 rng(17);
+        for (auto& x : v) x = keys[rng() % keys.size()];
+        double radix = bestOf(3, v, kernels::radixSort);
+        double intro = bestOf(3, v, introSortVec);
+        if (radix < intro) t.radixMaxDuplicates = dup + 0.125;
+    }
+
+    // 并行排序：单核机器上永远不启用
+    t.parallelMin = std::numeric_limits<std::size_t>::max();
+    unsigned threads = AdaptiveSort::threads();
+    if (threads > 1) {
+        for (std::size_t n = 1 << 14; n <= (1 << 23); n <<= 1) {
+            auto v = randomInts(n, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 19);
+            double par = bestOf(3, v, [threads](std::vector<int>& w) { kernels::parallelSort(w, threads); });
+            double best = std::min(bestOf(3, v, introSortVec), bestOf(3, v, kernels::radixSort));
+            if (par < best) {
+                t.parallelMin = n;
+                break;
+            }
+        }
+    }
+    return t;
+}
+
+void compare(const char* label, const std::vector<int>& input, const SortThresholds& t) {
+    AdaptiveSort adaptive(t);
+    std::vector<int> probe = input;
+    adaptive.sort(probe);
+    std::vector<int> expect = input;
+    std::sort(expect.begin(), expect.end());
+    if (probe != expect) {
+        std::cout << label << ": WRONG RESULT" << std::endl;
+        return;
+    }
+    double a = bestOf(3, input, [&adaptive](std::vector<int>& w) { adaptive.sort(w); });
+    double s = bestOf(3, input, [](std::vector<int>& w) { std::sort(w.begin(), w.end()); });
+    std::cout << label << ": " << AdaptiveSort::name(adaptive.lastChoice()) << " "
+              << a * 1e3 << " ms vs std::sort " << s * 1e3 << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    const std::string path = "sort_thresholds.txt";
+    SortThresholds thresholds;
+    bool force = argc > 1 && std::strcmp(argv[1], "--calibrate") == 0;
+    if (force || !thresholds.load(path)) {
+        std::cout << "Calibrating on this machine..." << std::endl;
+        thresholds = calibrate();
+        thresholds.save(path);
+    }
+    std::cout << "Thresholds: " << thresholds << std::endl;
+
+    Sorter sorter;
+    std::vector<int> data = {5, 2, 9, 1, 5, 6};
+    sorter.setStrategy(std::make_unique<AdaptiveSort>(thresholds));
+    sorter.executeSort(data);
+    for (int num : data) std::cout << num << " ";
+    std::cout << std::endl;
+
+    const std::size_t n = 1 << 20;
+    auto random = randomInts(n, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 1);
+    auto narrow = randomInts(n, 0, 1000, 2);
+    auto sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    auto nearly = sorted;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 100; ++i) std::swap(nearly[rng() % n], nearly[rng() % n]);
+    auto dups = randomInts(n, 0, 1 << 30, 4);
+    for (auto& x : dups) x = dups[static_cast<std::size_t>(x) % 64];
+
+    compare("random      ", random, thresholds);
+    compare("narrow range", narrow, thresholds);
+    compare("sorted      ", sorted, thresholds);
+    compare("nearly      ", nearly, thresholds);
+    compare("64 distinct ", dups, thresholds);
+    compare("small       ", randomInts(20, 0, 100, 5), thresholds);
+    return 0;
+}
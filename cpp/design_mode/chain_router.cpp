@@ -0,0 +1,253 @@
+// chain_router.cpp
+// 职责链的“编译”版本：构建时把链表展开成 level -> handler 的跳转表（或区间表），
+// 分发时不再逐个节点转发，也不会触碰 shared_ptr 的原子引用计数。
+// g++ -std=c++17 -O2 chain_router.cpp -o chain_router
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class Handler {
+public:
+    // 与 chain_of_respon.cpp 相同的语义：能处理就处理，否则交给下一个，链尾报告无人处理
+    void handleRequest(int level) {
+        if (level <= maxLevel()) {
+            process(level);
+        } else if (next_) {
+            next_->handleRequest(level);
+        } else {
+            unhandled(level);
+        }
+    }
+
+    void setNext(std::shared_ptr<Handler> next) { next_ = next; }
+    const std::shared_ptr<Handler>& next() const { return next_; }
+
+    virtual int maxLevel() const = 0;
+    virtual void process(int level) = 0;
+    virtual void unhandled(int level) {
+        std::cout << "No handler for level " << level << std::endl;
+    }
+    virtual ~Handler() = default;
+
+protected:
+    std::shared_ptr<Handler> next_;
+};
+
+class ConcreteHandler1 : public Handler {
+public:
+    int maxLevel() const override { return 3; }
+    void process(int level) override {
+        std::cout << "Handler1 processed level " << level << std::endl;
+    }
+};
+
+class ConcreteHandler2 : public Handler {
+public:
+    int maxLevel() const override { return 6; }
+    void process(int level) override {
+        std::cout << "Handler2 processed level " << level << std::endl;
+    }
+};
+
+class ConcreteHandler3 : public Handler {
+public:
+    int maxLevel() const override { return 9; }
+    void process(int level) override {
+        std::cout << "Handler3 processed level " << level << std::endl;
+    }
+};
+
+// 把链展开成有序区间：第 i 个区间 (bounds_[i-1], bounds_[i]] 归 targets_[i] 处理。
+// 被前面节点完全覆盖的 handler 永远轮不到，构建时直接丢弃。
+// 区间跨度不大时再展开成稠密跳转表，分发就是一次数组下标。
+class CompiledRouter {
+public:
+    static constexpr std::int64_t MaxTableSpan = 1 << 16;
+
+    explicit CompiledRouter(const std::shared_ptr<Handler>& head, bool allowTable = true) {
+        // 用 64 位记录已覆盖的上界，maxLevel() 为 INT_MIN 的 handler 也能进入区间表
+        std::int64_t covered = std::int64_t{INT_MIN} - 1;
+        Handler* tail = nullptr;
+        for (auto h = head; h; h = h->next()) {
+            owners_.push_back(h);
+            tail = h.get();
+            int upper = h->maxLevel();
+            if (upper > covered) {
+                bounds_.push_back(upper);
+                targets_.push_back(h.get());
+                covered = upper;
+            }
+        }
+        tail_ = tail;
+
+        if (allowTable && !bounds_.empty()) {
+            // 低于第一个上界的 level 全部归第一个 handler，表只需覆盖 [low_, high_]
+            low_ = bounds_.size() > 1 ? bounds_.front() : bounds_.back();
+            high_ = bounds_.back();
+            std::int64_t span = std::int64_t{high_} - low_;
+            if (span < MaxTableSpan) {
+                table_.resize(static_cast<std::size_t>(span + 1));
+                // 按偏移量循环：high_ 为 INT_MAX 时 level 不能再加一
+                std::size_t k = 0;
+                for (std::size_t offset = 0; offset < table_.size(); ++offset) {
+                    std::int64_t level = low_ + static_cast<std::int64_t>(offset);
+                    while (bounds_[k] < level) ++k;
+                    table_[offset] = targets_[k];
+                }
+            }
+        }
+    }
+
+    void handleRequest(int level) const {
+        if (Handler* h = route(level)) {
+            h->process(level);
+        } else if (tail_) {
+            tail_->unhandled(level);
+        }
+    }
+
+    Handler* route(int level) const {
+        if (bounds_.empty() || level > bounds_.back()) {
+            return nullptr;
+        }
+        if (!table_.empty()) {
+            return level <= low_ ? targets_.front()
+                                 : table_[static_cast<std::size_t>(std::int64_t{level} - low_)];
+        }
+        // 无分支二分：找第一个 bounds_[i] >= level
+        const int* base = bounds_.data();
+        std::size_t n = bounds_.size();
+        while (n > 1) {
+            std::size_t half = n / 2;
+            base = (base[half - 1] < level) ? base + half : base;
+            n -= half;
+        }
+        return targets_[static_cast<std::size_t>(base - bounds_.data())];
+    }
+
+    std::size_t reachable() const { return targets_.size(); }
+    bool usesTable() const { return !table_.empty(); }
+
+private:
+    std::vector<std::shared_ptr<Handler>> owners_;
+    std::vector<int> bounds_;
+    std::vector<Handler*> targets_;
+    std::vector<Handler*> table_;
+    Handler* tail_ = nullptr;
+    int low_ = 0;
+    int high_ = 0;
+};
+
+// 基准测试用：不打印，只计数
+class CountingHandler : public Handler {
+public:
+    explicit CountingHandler(int maxLevel) : maxLevel_(maxLevel) {}
+    int maxLevel() const override { return maxLevel_; }
+    void process(int) override { ++hits; }
+    void unhandled(int) override { ++misses; }
+    long hits = 0;
+    long misses = 0;
+
+private:
+    int maxLevel_;
+};
+
+std::shared_ptr<Handler> buildChain(int length, int step) {
+    std::shared_ptr<Handler> head;
+    for (int i = length; i >= 1; --i) {
+        auto h = std::make_shared<CountingHandler>(i * step);
+        h->setNext(head);
+        head = h;
+    }
+    return head;
+}
+
+template <typename Fn>
+double nsPerCall(const std::vector<int>& levels, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int level : levels) {
+        fn(level);
+    }
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return d.count() / levels.size();
+}
+
+void benchmark() {
+    const int step = 3;
+    const std::size_t requests = 1 << 20;
+    std::mt19937 rng(42);
+    std::cout << "chain  linked(ns)  table(ns)  interval(ns)" << std::endl;
+    for (int length : {3, 10, 30, 100, 300, 1000}) {
+        auto head = buildChain(length, step);
+        CompiledRouter table(head);
+        CompiledRouter interval(head, false);
+
+        std::uniform_int_distribution<int> pick(0, length * step + step);
+        std::vector<int> levels(requests);
+        for (auto& level : levels) level = pick(rng);
+
+        double linked = nsPerCall(levels, [&](int level) { head->handleRequest(level); });
+        double flat = nsPerCall(levels, [&](int level) { table.handleRequest(level); });
+        double bsearch = nsPerCall(levels, [&](int level) { interval.handleRequest(level); });
+        std::cout << length << "\t" << linked << "\t" << flat << "\t" << bsearch << std::endl;
+    }
+}
+
+int main() {
+    auto h1 = std::make_shared<ConcreteHandler1>();
+    auto h2 = std::make_shared<ConcreteHandler2>();
+    auto h3 = std::make_shared<ConcreteHandler3>();
+
+    h1->setNext(h2);
+    h2->setNext(h3);
+
+    CompiledRouter router(h1);
+    router.handleRequest(2);  // Handler1
+    router.handleRequest(5);  // Handler2
+    router.handleRequest(7);  // Handler3
+    router.handleRequest(10); // No handler
+
+    // 抽查：路由结果与逐个转发完全一致
+    auto same = [](const std::shared_ptr<Handler>& head, std::int64_t from, std::int64_t to) {
+        CompiledRouter table(head);
+        CompiledRouter interval(head, false);
+        for (std::int64_t l = from; l <= to; ++l) {
+            int level = static_cast<int>(l);
+            Handler* expect = nullptr;
+            for (auto h = head; h; h = h->next()) {
+                if (level <= h->maxLevel()) {
+                    expect = h.get();
+                    break;
+                }
+            }
+            if (table.route(level) != expect || interval.route(level) != expect) {
+                std::cout << "route mismatch at level " << level << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+    // 末尾是 maxLevel() == INT_MAX 的兜底 handler；开头是 maxLevel() == INT_MIN 的 handler
+    auto catchAll = std::make_shared<CountingHandler>(INT_MAX);
+    auto nearMax = std::make_shared<CountingHandler>(INT_MAX - 10);
+    nearMax->setNext(catchAll);
+    auto lowest = std::make_shared<CountingHandler>(INT_MIN);
+    auto middle = std::make_shared<CountingHandler>(3);
+    lowest->setNext(middle);
+    middle->setNext(catchAll);
+    if (!same(buildChain(50, 7), -5, 400) ||
+        !same(nearMax, std::int64_t{INT_MAX} - 20, INT_MAX) ||
+        !same(lowest, INT_MIN, std::int64_t{INT_MIN} + 5) || !same(lowest, -5, 5) ||
+        !same(lowest, std::int64_t{INT_MAX} - 5, INT_MAX)) {
+        return 1;
+    }
+
+    benchmark();
+    return 0;
+}
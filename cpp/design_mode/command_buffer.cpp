@@ -0,0 +1,395 @@
+// command_buffer.cpp
+// 命令模式的去虚化版本：命令以类型擦除的方式内联存放在连续缓冲区中，
+// 不再为每条命令单独 new，也不走虚函数表。
+// g++ -std=c++17 -O2 -pthread command_buffer.cpp -o command_buffer
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Light {
+public:
+    void on() { on_ = true; ++switches_; }
+    void off() { on_ = false; ++switches_; }
+    bool isOn() const { return on_; }
+    long switches() const { return switches_; }
+
+private:
+    bool on_ = false;
+    long switches_ = 0;
+};
+
+// 命令只需提供 operator()，无需继承 Command
+struct LightOn {
+    Light* light;
+    void operator()() const { light->on(); }
+};
+
+struct LightOff {
+    Light* light;
+    void operator()() const { light->off(); }
+};
+
+// 小缓冲区类型擦除：命令对象直接构造在 buf_ 中。执行函数直接存放在命令里，
+// 执行时少一次取函数表的访存；移动和析构不常用，放在静态函数表中
+class InlineCommand {
+public:
+    static constexpr std::size_t Capacity = 16;
+
+    template <typename F>
+    explicit InlineCommand(F&& f) {
+        using T = std::decay_t<F>;
+        static_assert(sizeof(T) <= Capacity, "command too large for inline storage");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned command");
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+                      "command must be nothrow move constructible");
+        ::new (static_cast<void*>(buf_)) T(std::forward<F>(f));
+        invoke_ = [](void* p) { (*static_cast<T*>(p))(); };
+        ops_ = &opsFor<T>;
+    }
+
+    InlineCommand(InlineCommand&& other) noexcept
+        : invoke_(other.invoke_), ops_(other.ops_) {
+        ops_->relocate(buf_, other.buf_);
+        other.invoke_ = [](void*) {};
+        other.ops_ = &emptyOps;
+    }
+
+    InlineCommand(const InlineCommand&) = delete;
+    InlineCommand& operator=(const InlineCommand&) = delete;
+    InlineCommand& operator=(InlineCommand&&) = delete;
+
+    ~InlineCommand() { ops_->destroy(buf_); }
+
+    void operator()() { invoke_(buf_); }
+
+private:
+    struct Ops {
+        void (*relocate)(void* dst, void* src);
+        void (*destroy)(void*);
+    };
+
+    template <typename T>
+    static constexpr Ops opsFor = {
+        [](void* dst, void* src) {
+            ::new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        },
+        [](void* p) { static_cast<T*>(p)->~T(); },
+    };
+
+    static constexpr Ops emptyOps = {
+        [](void*, void*) {},
+        [](void*) {},
+    };
+
+    void (*invoke_)(void*);
+    const Ops* ops_;
+    alignas(std::max_align_t) unsigned char buf_[Capacity];
+};
+
+// 常驻的工作线程：run(fn) 让 fn(0) 在调用线程上、fn(1..size()-1) 在各个工作线程上
+// 同时执行，全部完成后返回。线程只在构造时创建，反复执行时不再付创建和回收的开销
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned size) {
+        threads_.reserve(size - 1);
+        for (unsigned w = 1; w < size; ++w) {
+            threads_.emplace_back([this, w] { loop(w); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+    void run(const std::function<void(unsigned)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            pending_ = threads_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void loop(unsigned w) {
+        unsigned long seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                job = job_;
+            }
+            (*job)(w);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(unsigned)>* job_ = nullptr;
+    std::size_t pending_ = 0;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+// 连续存放的命令流，可反复执行（重放）。
+// 录制时按目标把命令的下标分到 Lanes 条通道：同一目标总在同一通道，
+// 并行执行时每个线程只遍历分给自己的通道
+class CommandBuffer {
+public:
+    static constexpr unsigned Lanes = 16;
+    static constexpr std::uintptr_t CacheLine = 64;
+
+    void reserve(std::size_t n) { commands_.reserve(n); }
+
+    void clear() {
+        commands_.clear();
+        for (auto& lane : lanes_) {
+            lane.clear();
+        }
+    }
+
+    std::size_t size() const { return commands_.size(); }
+
+    template <typename F>
+    void add(const void* target, F&& f) {
+        lanes_[laneOf(target)].push_back(static_cast<std::uint32_t>(commands_.size()));
+        commands_.emplace_back(std::forward<F>(f));
+    }
+
+    void executeAll() {
+        for (auto& cmd : commands_) {
+            cmd();
+        }
+    }
+
+    // 用 threads 个线程（含调用线程）执行，同一目标上的命令仍保持录制顺序
+    void executeAll(unsigned threads) {
+        threads = std::min(threads, Lanes);
+        if (threads <= 1 || commands_.size() < 2) {
+            executeAll();
+            return;
+        }
+        if (!pool_ || pool_->size() != threads) {
+            pool_ = std::make_unique<WorkerPool>(threads);
+        }
+        pool_->run([this, threads](unsigned w) {
+            for (unsigned lane = w; lane < Lanes; lane += threads) {
+                for (std::uint32_t i : lanes_[lane]) {
+                    commands_[i]();
+                }
+            }
+        });
+    }
+
+private:
+    // 按缓存行分通道：同一缓存行上的目标由同一个线程修改，不会伪共享
+    static unsigned laneOf(const void* target) {
+        return static_cast<unsigned>(reinterpret_cast<std::uintptr_t>(target) / CacheLine % Lanes);
+    }
+
+    std::vector<InlineCommand> commands_;
+    std::vector<std::uint32_t> lanes_[Lanes];
+    std::unique_ptr<WorkerPool> pool_;
+};
+
+class RemoteControl {
+public:
+    template <typename F>
+    void addCommand(const void* target, F&& f) {
+        queue_.add(target, std::forward<F>(f));
+    }
+
+    void executeAll(unsigned threads = 1) { queue_.executeAll(threads); }
+
+    // 立即执行一条命令；录制期间同时追加到宏中
+    template <typename F>
+    void press(const void* target, F&& f) {
+        f();
+        if (recording_) {
+            macro_.add(target, std::forward<F>(f));
+        }
+    }
+
+    void startRecording() {
+        macro_.clear();
+        recording_ = true;
+    }
+
+    void stopRecording() { recording_ = false; }
+
+    void replay(unsigned threads = 1) { macro_.executeAll(threads); }
+
+private:
+    CommandBuffer queue_;
+    CommandBuffer macro_;
+    bool recording_ = false;
+};
+
+// 对照组：与 command.cpp 相同的虚函数 + unique_ptr 设计
+namespace classic {
+
+class Command {
+public:
+    virtual void execute() = 0;
+    virtual ~Command() = default;
+};
+
+class LightOnCommand : public Command {
+    Light& light_;
+public:
+    explicit LightOnCommand(Light& light) : light_(light) {}
+    void execute() override { light_.on(); }
+};
+
+class LightOffCommand : public Command {
+    Light& light_;
+public:
+    explicit LightOffCommand(Light& light) : light_(light) {}
+    void execute() override { light_.off(); }
+};
+
+class RemoteControl {
+    std::vector<std::unique_ptr<Command>> commands_;
+public:
+    void addCommand(std::unique_ptr<Command> cmd) {
+        commands_.push_back(std::move(cmd));
+    }
+
+    void executeAll() {
+        for (auto& cmd : commands_) {
+            cmd->execute();
+        }
+    }
+};
+
+} // namespace classic
+
+template <typename Fn>
+double seconds(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+// 重放多次取最快的一次：第一次执行还包含缺页和工作线程的创建
+template <typename Fn>
+double bestOf(int runs, Fn&& fn) {
+    double best = seconds(fn);
+    for (int r = 1; r < runs; ++r) {
+        best = std::min(best, seconds(fn));
+    }
+    return best;
+}
+
+void report(const char* name, std::size_t n, double build, double run) {
+    std::cout << name << ": build " << n / build / 1e6 << " M cmd/s, execute "
+              << n / run / 1e6 << " M cmd/s" << std::endl;
+}
+
+void benchmark(std::size_t n) {
+    const std::size_t lights = 64;
+    const int runs = 5;
+    std::cout << "--- " << n << " commands on " << lights << " lights ---" << std::endl;
+
+    {
+        std::vector<Light> rooms(lights);
+        classic::RemoteControl remote;
+        double build = seconds([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                Light& l = rooms[i % lights];
+                if (i & 1)
+                    remote.addCommand(std::make_unique<classic::LightOffCommand>(l));
+                else
+                    remote.addCommand(std::make_unique<classic::LightOnCommand>(l));
+            }
+        });
+        double run = bestOf(runs, [&] { remote.executeAll(); });
+        report("unique_ptr<Command>", n, build, run);
+    }
+
+    std::vector<Light> rooms(lights);
+    CommandBuffer buffer;
+    double build = seconds([&] {
+        buffer.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            Light* l = &rooms[i % lights];
+            if (i & 1)
+                buffer.add(l, LightOff{l});
+            else
+                buffer.add(l, LightOn{l});
+        }
+    });
+    double run = bestOf(runs, [&] { buffer.executeAll(); });
+    report("CommandBuffer      ", n, build, run);
+
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    double par = bestOf(runs, [&] { buffer.executeAll(threads); });
+    std::cout << "CommandBuffer x" << threads << " threads: execute "
+              << n / par / 1e6 << " M cmd/s" << std::endl;
+
+    long total = 0;
+    for (const auto& l : rooms) total += l.switches();
+    std::cout << "switches: " << total << " (expected " << 2 * runs * n << ")" << std::endl;
+}
+
+int main() {
+    Light livingRoom, kitchen;
+    RemoteControl remote;
+
+    remote.addCommand(&livingRoom, LightOn{&livingRoom});
+    remote.addCommand(&kitchen, LightOn{&kitchen});
+    remote.addCommand(&livingRoom, LightOff{&livingRoom});
+    remote.executeAll(2);
+    std::cout << "living room " << (livingRoom.isOn() ? "ON" : "OFF")
+              << ", kitchen " << (kitchen.isOn() ? "ON" : "OFF") << std::endl;
+
+    remote.startRecording();
+    remote.press(&kitchen, LightOff{&kitchen});
+    remote.press(&livingRoom, [&livingRoom] { livingRoom.on(); });
+    remote.stopRecording();
+    kitchen.on();
+    livingRoom.off();
+    remote.replay();
+    std::cout << "after replay: living room " << (livingRoom.isOn() ? "ON" : "OFF")
+              << ", kitchen " << (kitchen.isOn() ? "ON" : "OFF") << std::endl;
+
+    benchmark(1 << 20);
+    return 0;
+}
@@ -0,0 +1,425 @@
+// pipeline_processor.cpp
+// 模板方法的流水线版本：process() 仍然固定 loadData -> analyzeData -> saveResult 的骨架，
+// 但三个阶段并发运行，阶段之间用有界队列衔接，并统计每个阶段的耗时。
+// CSVProcessor 用 mmap 读入文件、按行边界切块，多个线程并行解析并统计数值列。
+// g++ -std=c++17 -O2 -pthread pipeline_processor.cpp -o pipeline_processor
+// ./pipeline_processor [file.csv]   # 不给文件时生成一个测试用 CSV，结束时删除
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// 有界阻塞队列：满了 push 等待，空了 pop 等待；close() 之后 pop 取完剩余元素返回 false
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+// 每个阶段的忙碌时间与等待时间（纳秒，可被多个线程累加）
+struct StageTimer {
+    const char* name;
+    std::atomic<long long> busyNs{0};
+    std::atomic<long long> waitNs{0};
+    std::atomic<long long> items{0};
+
+    explicit StageTimer(const char* n) : name(n) {}
+
+    template <typename Fn>
+    auto busy(Fn&& fn) {
+        auto start = Clock::now();
+        auto guard = finally([&] { busyNs += elapsedNs(start); });
+        return fn();
+    }
+
+    template <typename Fn>
+    auto wait(Fn&& fn) {
+        auto start = Clock::now();
+        auto guard = finally([&] { waitNs += elapsedNs(start); });
+        return fn();
+    }
+
+private:
+    template <typename Fn>
+    struct Finally {
+        Fn fn;
+        ~Finally() { fn(); }
+    };
+    template <typename Fn>
+    static Finally<Fn> finally(Fn fn) { return Finally<Fn>{fn}; }
+
+    static long long elapsedNs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+};
+
+// 一段待分析的数据：[begin, end) 只包含完整的行
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+};
+
+// 每列的统计量；分析线程各自累积，最后在 saveResult 阶段合并
+struct ColumnStats {
+    long long numeric = 0;
+    long long text = 0;
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double v) {
+        ++numeric;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+
+    void merge(const ColumnStats& o) {
+        numeric += o.numeric;
+        text += o.text;
+        sum += o.sum;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+};
+
+struct Summary {
+    long long rows = 0;
+    long long bytes = 0;
+    std::vector<ColumnStats> columns;
+
+    void merge(const Summary& o) {
+        rows += o.rows;
+        bytes += o.bytes;
+        if (columns.size() < o.columns.size()) columns.resize(o.columns.size());
+        for (std::size_t i = 0; i < o.columns.size(); ++i) columns[i].merge(o.columns[i]);
+    }
+};
+
+class DataProcessor {
+public:
+    // 模板方法：骨架不变，三个阶段并发执行
+    void process(unsigned analyzers = std::max(1u, std::thread::hardware_concurrency())) {
+        BoundedQueue<Chunk> chunks(2 * analyzers + 2);
+        BoundedQueue<Summary> partials(2 * analyzers + 2);
+        StageTimer load("load"), analyze("analyze"), save("save");
+        auto start = Clock::now();
+
+        std::thread loader([&] {
+            Chunk c;
+            while (load.busy([&] { return loadData(c); })) {
+                ++load.items;
+                load.wait([&] { chunks.push(c); return 0; });
+            }
+            chunks.close();
+        });
+
+        std::vector<std::thread> workers;
+        std::atomic<unsigned> running{analyzers};
+        for (unsigned i = 0; i < analyzers; ++i) {
+            workers.emplace_back([&] {
+                Chunk c;
+                while (analyze.wait([&] { return chunks.pop(c); })) {
+                    Summary part = analyze.busy([&] { return analyzeData(c); });
+                    ++analyze.items;
+                    analyze.wait([&] { partials.push(std::move(part)); return 0; });
+                }
+                if (--running == 0) partials.close();
+            });
+        }
+
+        Summary total;
+        Summary part;
+        while (save.wait([&] { return partials.pop(part); })) {
+            save.busy([&] { total.merge(part); return 0; });
+            ++save.items;
+        }
+        loader.join();
+        for (auto& w : workers) w.join();
+        save.busy([&] { saveResult(total); return 0; });
+
+        std::chrono::duration<double> wall = Clock::now() - start;
+        report(wall.count(), total, {&load, &analyze, &save}, analyzers);
+    }
+
+    virtual ~DataProcessor() = default;
+
+protected:
+    // 产出下一块数据；没有更多数据时返回 false。只在加载线程上调用
+    virtual bool loadData(Chunk& chunk) = 0;
+    // 分析一块数据；会在多个线程上同时调用
+    virtual Summary analyzeData(const Chunk& chunk) = 0;
+    virtual void saveResult(const Summary& total) {
+        std::cout << "Saving results to database... (" << total.rows << " rows)" << std::endl;
+    }
+
+private:
+    static void report(double wall, const Summary& total,
+                       std::initializer_list<StageTimer*> stages, unsigned analyzers) {
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "stage      items    busy(s)   wait(s)" << std::endl;
+        for (auto* s : stages) {
+            std::cout << std::left << std::setw(10) << s->name << std::right
+                      << std::setw(6) << s->items.load()
+                      << std::setw(11) << s->busyNs.load() / 1e9
+                      << std::setw(10) << s->waitNs.load() / 1e9 << std::endl;
+        }
+        std::cout << "wall " << wall << " s with " << analyzers << " analyzer thread(s), "
+                  << total.bytes / wall / 1e9 << " GB/s, "
+                  << total.rows / wall / 1e6 << " M rows/s" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+};
+
+class CSVProcessor : public DataProcessor {
+public:
+    explicit CSVProcessor(const std::string& path, std::size_t chunkBytes = 4 << 20)
+        : chunkBytes_(chunkBytes) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("cannot mmap " + path);
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+        }
+        // 第一行是表头
+        const char* nl = data_ ? static_cast<const char*>(std::memchr(data_, '\n', size_)) : nullptr;
+        const char* headerEnd = nl ? nl : data_ + size_;
+        for (std::string_view f : splitFields(data_, headerEnd)) header_.emplace_back(f);
+        cursor_ = nl ? nl + 1 : headerEnd;
+    }
+
+    ~CSVProcessor() override {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    CSVProcessor(const CSVProcessor&) = delete;
+    CSVProcessor& operator=(const CSVProcessor&) = delete;
+
+    const std::vector<std::string>& header() const { return header_; }
+
+protected:
+    // 按字节数切块，再延伸到下一个换行；同时逐页预读，让缺页发生在加载线程上
+    bool loadData(Chunk& chunk) override {
+        const char* end = data_ + size_;
+        if (cursor_ >= end) return false;
+        const char* stop = cursor_ + std::min<std::size_t>(chunkBytes_, end - cursor_);
+        if (stop < end) {
+            const char* nl = static_cast<const char*>(std::memchr(stop, '\n', end - stop));
+            stop = nl ? nl + 1 : end;
+        }
+        volatile char sink = 0;
+        for (const char* p = cursor_; p < stop; p += 4096) sink = sink + *p;
+        chunk.begin = cursor_;
+        chunk.end = stop;
+        cursor_ = stop;
+        return true;
+    }
+
+    Summary analyzeData(const Chunk& chunk) override {
+        Summary s;
+        s.bytes = chunk.end - chunk.begin;
+        s.columns.resize(header_.size());
+        const char* p = chunk.begin;
+        while (p < chunk.end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+            const char* lineEnd = nl ? nl : chunk.end;
+            if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+            if (lineEnd > p) {
+                ++s.rows;
+                std::size_t col = 0;
+                forEachField(p, lineEnd, [&](std::string_view f) {
+                    if (col >= s.columns.size()) s.columns.resize(col + 1);
+                    double v;
+                    auto r = std::from_chars(f.data(), f.data() + f.size(), v);
+                    if (!f.empty() && r.ec == std::errc() && r.ptr == f.data() + f.size())
+                        s.columns[col].add(v);
+                    else
+                        ++s.columns[col].text;
+                    ++col;
+                });
+            }
+            p = nl ? nl + 1 : chunk.end;
+        }
+        return s;
+    }
+
+    void saveResult(const Summary& total) override {
+        std::cout << "CSV summary: " << total.rows << " rows" << std::endl;
+        for (std::size_t i = 0; i < total.columns.size(); ++i) {
+            const ColumnStats& c = total.columns[i];
+            std::cout << "  " << (i < header_.size() ? header_[i] : "col" + std::to_string(i));
+            if (c.numeric > 0)
+                std::cout << ": mean " << c.sum / c.numeric << ", min " << c.min << ", max " << c.max;
+            if (c.text > 0) std::cout << " (" << c.text << " text values)";
+            std::cout << std::endl;
+        }
+    }
+
+private:
+    // 字段以逗号分隔；双引号字段内可以有逗号和 "" 转义，但不支持跨行
+    template <typename Fn>
+    static void forEachField(const char* p, const char* end, Fn&& fn) {
+        for (;;) {
+            if (p < end && *p == '"') {
+                const char* q = p + 1;
+                while (q < end && !(*q == '"' && (q + 1 == end || q[1] != '"'))) q += (*q == '"') ? 2 : 1;
+                fn(std::string_view(p + 1, static_cast<std::size_t>(std::min(q, end) - p - 1)));
+                p = std::min(q + 1, end);
+                const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+                if (!comma) return;
+                p = comma + 1;
+                continue;
+            }
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+            const char* fieldEnd = comma ? comma : end;
+            fn(std::string_view(p, static_cast<std::size_t>(fieldEnd - p)));
+            if (!comma) return;
+            p = comma + 1;
+        }
+    }
+
+    static std::vector<std::string_view> splitFields(const char* p, const char* end) {
+        std::vector<std::string_view> out;
+        if (!p || p == end) return out;
+        if (end[-1] == '\r') --end;
+        forEachField(p, end, [&](std::string_view f) { out.push_back(f); });
+        return out;
+    }
+
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t chunkBytes_;
+    const char* cursor_ = nullptr;
+    std::vector<std::string> header_;
+};
+
+// 对照组：逐行 getline + stringstream + strtod，单线程顺序执行
+Summary sequentialBaseline(const std::string& path) {
+    std::ifstream in(path);
+    std::string line, field;
+    std::getline(in, line);
+    Summary s;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        ++s.rows;
+        s.bytes += static_cast<long long>(line.size()) + 1;
+        std::stringstream ss(line);
+        std::size_t col = 0;
+        while (std::getline(ss, field, ',')) {
+            if (col >= s.columns.size()) s.columns.resize(col + 1);
+            // strtod 加结束指针判断，不用 stod：每个文本字段都抛异常会让对照组
+            // 主要在测异常展开，而不是解析
+            const char* begin = field.c_str();
+            char* used = nullptr;
+            errno = 0;
+            double v = std::strtod(begin, &used);
+            if (used != begin && used == begin + field.size() && errno != ERANGE)
+                s.columns[col].add(v);
+            else
+                ++s.columns[col].text;
+            ++col;
+        }
+    }
+    return s;
+}
+
+std::string writeSample(std::size_t rows) {
+    std::string path = "pipeline_sample.csv";
+    std::ofstream out(path);
+    out << "id,city,temperature,humidity,pressure\n";
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> temp(-20, 40), hum(0, 100), pres(950, 1050);
+    const char* cities[] = {"Beijing", "Shanghai", "Shenzhen", "Hangzhou"};
+    char buf[128];
+    for (std::size_t i = 0; i < rows; ++i) {
+        int n = std::snprintf(buf, sizeof buf, "%zu,%s,%.2f,%.1f,%.1f\n", i, cities[i % 4],
+                              temp(rng), hum(rng), pres(rng));
+        out.write(buf, n);
+    }
+    return path;
+}
+
+int main(int argc, char* argv[]) {
+    bool generated = argc <= 1;
+    std::string path = generated ? writeSample(2000000) : argv[1];
+
+    CSVProcessor csv(path);
+    csv.process();
+
+    auto start = Clock::now();
+    Summary base = sequentialBaseline(path);
+    std::chrono::duration<double> d = Clock::now() - start;
+    std::cout << "getline/stringstream baseline: " << base.rows << " rows, "
+              << base.bytes / d.count() / 1e9 << " GB/s" << std::endl;
+    if (generated) std::remove(path.c_str());
+    return 0;
+}
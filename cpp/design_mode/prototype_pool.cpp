@@ -0,0 +1,309 @@
+// prototype_pool.cpp
+// 原型模式 + 对象池：克隆出的对象放在按类型划分的 slab 中，
+// 用自定义删除器归还到池里，避免每次 getClone 都走一次 malloc/free。
+// g++ -std=c++17 -O2 prototype_pool.cpp -o prototype_pool
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// 统计全局 operator new 次数，用来对比两条路径的分配量
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t al) {
+    ++g_allocations;
+    std::size_t a = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// 固定大小块的 slab 池：空闲块串成单链表，不够时整块申请新 slab
+class SlabPool {
+public:
+    SlabPool(std::size_t blockSize, std::size_t align, std::size_t blocksPerSlab = 256)
+        : blockSize_(roundUp(std::max(blockSize, sizeof(FreeNode)), align)),
+          align_(align), blocksPerSlab_(blocksPerSlab) {}
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+        for (auto& s : slabs_) {
+            ::operator delete(s.memory, std::align_val_t(align_));
+        }
+    }
+
+    void* allocate() {
+        if (free_) {
+            FreeNode* node = free_;
+            free_ = node->next;
+            ++live_;
+            return node;
+        }
+        return allocateRun(1);
+    }
+
+    // 取 n 个地址连续的块：依次在已有 slab 的未用尾部里找，都放不下才申请新 slab
+    void* allocateRun(std::size_t n) {
+        const std::size_t bytes = n * blockSize_;
+        while (static_cast<std::size_t>(end_ - bump_) < bytes) {
+            if (cursor_ + 1 < slabs_.size()) {
+                enterSlab(++cursor_);
+                continue;
+            }
+            std::size_t blocks = std::max(n, blocksPerSlab_);
+            auto* mem = static_cast<char*>(
+                ::operator new(blocks * blockSize_, std::align_val_t(align_)));
+            slabs_.push_back({mem, blocks});
+            enterSlab(cursor_ = slabs_.size() - 1);
+        }
+        char* run = bump_;
+        bump_ += bytes;
+        live_ += n;
+        return run;
+    }
+
+    // 对象全部归还后，丢弃空闲链表，从第一个 slab 重新顺序切分，
+    // 这样反复的 cloneN 不会让 slab 数量一直增长
+    void deallocate(void* p) {
+        auto* node = static_cast<FreeNode*>(p);
+        node->next = free_;
+        free_ = node;
+        if (--live_ == 0) {
+            free_ = nullptr;
+            enterSlab(cursor_ = 0);
+        }
+    }
+
+    std::size_t blockSize() const { return blockSize_; }
+    std::size_t slabCount() const { return slabs_.size(); }
+    std::size_t live() const { return live_; }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+    struct Slab {
+        char* memory;
+        std::size_t blocks;
+    };
+
+    void enterSlab(std::size_t i) {
+        bump_ = slabs_[i].memory;
+        end_ = bump_ + slabs_[i].blocks * blockSize_;
+    }
+
+    static std::size_t roundUp(std::size_t n, std::size_t a) { return (n + a - 1) / a * a; }
+
+    std::size_t blockSize_;
+    std::size_t align_;
+    std::size_t blocksPerSlab_;
+    std::vector<Slab> slabs_;
+    FreeNode* free_ = nullptr;
+    char* bump_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t cursor_ = 0;
+    std::size_t live_ = 0;
+};
+
+class Shape;
+
+// 析构对象并把内存还给它所属的池
+struct PoolDeleter {
+    SlabPool* pool;
+    void operator()(Shape* s) const;
+};
+
+using PooledShape = std::unique_ptr<Shape, PoolDeleter>;
+
+class Shape {
+public:
+    virtual std::unique_ptr<Shape> clone() const = 0;
+    virtual Shape* cloneAt(void* memory) const = 0;  // 在给定内存上拷贝构造
+    virtual std::size_t objectSize() const = 0;
+    virtual std::size_t objectAlign() const = 0;
+    virtual void draw() const = 0;
+    virtual ~Shape() = default;
+};
+
+void PoolDeleter::operator()(Shape* s) const {
+    void* memory = dynamic_cast<void*>(s);
+    s->~Shape();
+    pool->deallocate(memory);
+}
+
+// 为具体类型统一实现克隆相关的虚函数
+template <typename Derived>
+class ClonableShape : public Shape {
+public:
+    std::unique_ptr<Shape> clone() const override {
+        return std::make_unique<Derived>(static_cast<const Derived&>(*this));
+    }
+    Shape* cloneAt(void* memory) const override {
+        return ::new (memory) Derived(static_cast<const Derived&>(*this));
+    }
+    std::size_t objectSize() const override { return sizeof(Derived); }
+    std::size_t objectAlign() const override { return alignof(Derived); }
+};
+
+class Circle : public ClonableShape<Circle> {
+public:
+    Circle(int x, int y, int r) : x_(x), y_(y), radius_(r) {}
+
+    void draw() const override {
+        std::cout << "Drawing Circle at (" << x_ << "," << y_
+                  << ") with radius " << radius_ << std::endl;
+    }
+
+private:
+    int x_, y_, radius_;
+};
+
+class Rectangle : public ClonableShape<Rectangle> {
+public:
+    Rectangle(int x, int y, int w, int h) : x_(x), y_(y), w_(w), h_(h) {}
+
+    void draw() const override {
+        std::cout << "Drawing Rectangle at (" << x_ << "," << y_
+                  << ") size " << w_ << "x" << h_ << std::endl;
+    }
+
+private:
+    int x_, y_, w_, h_;
+};
+
+// 克隆出的 PooledShape 必须在 ShapeCache 之前销毁；不做线程同步
+class ShapeCache {
+public:
+    void addPrototype(const std::string& key, std::unique_ptr<Shape> shape) {
+        const Shape& s = *shape;
+        auto& pool = pools_[std::type_index(typeid(s))];
+        if (!pool) {
+            pool = std::make_unique<SlabPool>(s.objectSize(), s.objectAlign());
+        }
+        prototypes_[key] = Entry{std::move(shape), pool.get()};
+    }
+
+    // 原有接口：每次一个堆对象
+    std::unique_ptr<Shape> getClone(const std::string& key) {
+        return prototypes_.at(key).prototype->clone();
+    }
+
+    PooledShape getPooledClone(const std::string& key) {
+        Entry& e = prototypes_.at(key);
+        return PooledShape(e.prototype->cloneAt(e.pool->allocate()), PoolDeleter{e.pool});
+    }
+
+    // 批量克隆：n 个对象构造在同一段连续 slab 内存上
+    std::vector<PooledShape> cloneN(const std::string& key, std::size_t n) {
+        Entry& e = prototypes_.at(key);
+        std::vector<PooledShape> out;
+        out.reserve(n);
+        if (n == 0) return out;
+        char* run = static_cast<char*>(e.pool->allocateRun(n));
+        std::size_t stride = e.pool->blockSize();
+        for (std::size_t i = 0; i < n; ++i) {
+            out.emplace_back(e.prototype->cloneAt(run + i * stride), PoolDeleter{e.pool});
+        }
+        return out;
+    }
+
+    std::size_t slabCount() const {
+        std::size_t n = 0;
+        for (const auto& p : pools_) n += p.second->slabCount();
+        return n;
+    }
+
+private:
+    struct Entry {
+        std::unique_ptr<Shape> prototype;
+        SlabPool* pool = nullptr;
+    };
+
+    // pools_ 先于 prototypes_ 声明，保证池最后销毁
+    std::unordered_map<std::type_index, std::unique_ptr<SlabPool>> pools_;
+    std::unordered_map<std::string, Entry> prototypes_;
+};
+
+template <typename Fn>
+void measure(const char* name, std::size_t clones, Fn&& fn) {
+    std::size_t before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << clones / d.count() / 1e6 << " M clones/s, "
+              << g_allocations - before << " allocations" << std::endl;
+}
+
+void benchmark(ShapeCache& cache) {
+    const std::size_t live = 4096;   // 同时存活的对象数
+    const std::size_t rounds = 256;
+    const std::size_t total = live * rounds;
+    std::cout << "--- " << total << " clones, " << live << " alive at a time ---" << std::endl;
+
+    measure("getClone       ", total, [&] {
+        std::vector<std::unique_ptr<Shape>> shapes(live);
+        for (std::size_t r = 0; r < rounds; ++r)
+            for (std::size_t i = 0; i < live; ++i)
+                shapes[i] = cache.getClone(i & 1 ? "unit_circle" : "square");
+    });
+
+    measure("getPooledClone ", total, [&] {
+        std::vector<PooledShape> shapes;
+        shapes.reserve(live);
+        for (std::size_t i = 0; i < live; ++i)
+            shapes.push_back(cache.getPooledClone(i & 1 ? "unit_circle" : "square"));
+        for (std::size_t r = 1; r < rounds; ++r)
+            for (std::size_t i = 0; i < live; ++i)
+                shapes[i] = cache.getPooledClone(i & 1 ? "unit_circle" : "square");
+    });
+
+    measure("cloneN         ", total, [&] {
+        for (std::size_t r = 0; r < rounds; ++r) {
+            auto batch = cache.cloneN("unit_circle", live);
+        }
+    });
+    std::cout << "slabs held by pools: " << cache.slabCount() << std::endl;
+}
+
+int main() {
+    ShapeCache cache;
+    cache.addPrototype("unit_circle", std::make_unique<Circle>(0, 0, 1));
+    cache.addPrototype("big_circle", std::make_unique<Circle>(0, 0, 10));
+    cache.addPrototype("square", std::make_unique<Rectangle>(0, 0, 5, 5));
+
+    auto circle1 = cache.getPooledClone("unit_circle");
+    circle1->draw();
+
+    auto circle2 = cache.getPooledClone("big_circle");
+    circle2->draw();
+
+    auto squares = cache.cloneN("square", 3);
+    for (const auto& s : squares) s->draw();
+
+    circle1.reset();
+    circle2.reset();
+    squares.clear();
+
+    benchmark(cache);
+    return 0;
+}